@@ -0,0 +1,8 @@
+#ifndef ALLOCATION_COUNTER_H
+#define ALLOCATION_COUNTER_H
+
+// Total calls to the global operator new since program start. Only available in
+// binaries that link AllocationCounter.cpp, which replaces the global allocator.
+unsigned long long allocationCount();
+
+#endif // ALLOCATION_COUNTER_H
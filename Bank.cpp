@@ -1,30 +1,176 @@
 #include "InvestmentSimulator.h"
+#include "DetailFormat.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+// Status of a batched operation for every combination of its inputs, so applyOperations can look
+// it up instead of branching. Filled from the same checks, in the same order, as tryDepositFunds,
+// tryWithdrawFunds and tryExecuteInvestment.
+class OperationStatusTable {
+public:
+    OperationStatusTable() {
+        for (unsigned key = 0; key < 32; ++key) {
+            const unsigned type = key & 3;
+            const bool nonPositive = (key & 4) != 0;
+            const bool covered = (key & 8) != 0;
+            const bool hasStrategy = (key & 16) != 0;
+            InvestmentStatus status = StatusOk;
+            if (type == OperationDeposit)
+                status = nonPositive ? StatusInvalidDeposit : StatusOk;
+            else if (type == OperationWithdrawal)
+                status = nonPositive ? StatusInvalidWithdrawal : !covered ? StatusInsufficientFunds : StatusOk;
+            else
+                status = !hasStrategy ? StatusNoStrategy : nonPositive ? StatusInvalidAmount
+                       : !covered ? StatusInsufficientFunds : StatusOk;
+            statuses[key] = static_cast<std::uint8_t>(status);
+        }
+    }
+
+    InvestmentStatus lookup(unsigned type, bool nonPositive, bool covered, bool hasStrategy) const {
+        return static_cast<InvestmentStatus>(statuses[type | static_cast<unsigned>(nonPositive) << 2 |
+                                                      static_cast<unsigned>(covered) << 3 |
+                                                      static_cast<unsigned>(hasStrategy) << 4]);
+    }
+
+private:
+    std::uint8_t statuses[32];
+};
+
+const OperationStatusTable operationStatuses;
+
+} // namespace
 
 Bank::Bank(const std::string& bankName, double initialFunds)
-    : name(bankName), availableFunds(initialFunds) {
+    : borrowedStrategy(nullptr), name(bankName), availableFunds(initialFunds) {
     if (initialFunds < 0.0)
         throw InvestmentException("Initial funds cannot be negative");
 }
 
+Bank::Bank(const std::string& bankName, double initialFunds, std::shared_ptr<InvestmentStrategy> initialStrategy)
+    : strategy(std::move(initialStrategy)), borrowedStrategy(nullptr), name(bankName), availableFunds(initialFunds) {
+    if (initialFunds < 0.0)
+        throw InvestmentException("Initial funds cannot be negative");
+}
+
+Bank::Bank(const Bank& other)
+    : borrowedStrategy(nullptr), name(other.name), availableFunds(other.availableFunds.load()) {
+    // Copy the pair under the source's setter lock so the copy never sees both pointers cleared
+    std::lock_guard<std::mutex> lock(other.strategyMutex);
+    strategy = std::atomic_load(&other.strategy);
+    borrowedStrategy.store(other.borrowedStrategy.load());
+}
+
+Bank& Bank::operator=(const Bank& other) {
+    if (this != &other) {
+        std::lock(strategyMutex, other.strategyMutex);
+        std::lock_guard<std::mutex> lock(strategyMutex, std::adopt_lock);
+        std::lock_guard<std::mutex> otherLock(other.strategyMutex, std::adopt_lock);
+        std::atomic_store(&strategy, std::atomic_load(&other.strategy));
+        borrowedStrategy.store(other.borrowedStrategy.load());
+        name = other.name;
+        availableFunds.store(other.availableFunds.load());
+    }
+    return *this;
+}
+
+// Compare-and-swap loop: the balance is only decremented from a value that covers the amount
+bool Bank::reserveFunds(double amount) {
+    double current = availableFunds.load();
+    while (amount <= current) {
+        if (availableFunds.compare_exchange_weak(current, current - amount))
+            return true;
+    }
+    return false;
+}
+
+void Bank::releaseFunds(double amount) {
+    double current = availableFunds.load();
+    while (!availableFunds.compare_exchange_weak(current, current + amount)) {
+    }
+}
+
 void Bank::setStrategy(std::shared_ptr<InvestmentStrategy> newStrategy) {
     if (!newStrategy)
         throw InvestmentException("Strategy cannot be null");
-    strategy = newStrategy;
+    std::lock_guard<std::mutex> lock(strategyMutex);
+    std::atomic_store(&strategy, newStrategy);
+    borrowedStrategy.store(nullptr);
+}
+
+void Bank::setBorrowedStrategy(const InvestmentStrategy* newStrategy) {
+    if (!newStrategy)
+        throw InvestmentException("Strategy cannot be null");
+    std::lock_guard<std::mutex> lock(strategyMutex);
+    borrowedStrategy.store(newStrategy);
+    std::atomic_store(&strategy, std::shared_ptr<InvestmentStrategy>());
+}
+
+std::shared_ptr<const InvestmentStrategy> Bank::getStrategy() const {
+    const InvestmentStrategy* borrowed = borrowedStrategy.load(std::memory_order_acquire);
+    if (borrowed)
+        return std::shared_ptr<const InvestmentStrategy>(std::shared_ptr<const InvestmentStrategy>(), borrowed);
+    std::shared_ptr<const InvestmentStrategy> current = std::atomic_load(&strategy);
+    if (current)
+        return current;
+    borrowed = borrowedStrategy.load(std::memory_order_acquire);
+    return std::shared_ptr<const InvestmentStrategy>(std::shared_ptr<const InvestmentStrategy>(), borrowed);
 }
 
 double Bank::executeInvestment(double amount) {
-    if (!strategy)
-        throw InvestmentException("No investment strategy set");
-    if (amount > availableFunds)
-        throw InvestmentException("Insufficient funds for investment");
-    availableFunds -= amount;
-    return strategy->invest(amount);
+    return tryExecuteInvestment(amount).valueOrThrow();
+}
+
+InvestmentResult Bank::tryExecuteInvestment(double amount) {
+    INVESTMENT_METRIC_COUNT(MetricBankInvestments);
+    INVESTMENT_METRIC_TIME(MetricBankExecuteLatency);
+    const InvestmentStrategy* borrowed = borrowedStrategy.load(std::memory_order_acquire);
+    if (borrowed)
+        return investWith(*borrowed, amount);
+    // Investments already in flight keep the strategy they loaded, even across setStrategy
+    std::shared_ptr<InvestmentStrategy> current = std::atomic_load(&strategy);
+    if (current)
+        return investWith(*current, amount);
+    // setBorrowedStrategy publishes the borrowed pointer before dropping the owned one
+    borrowed = borrowedStrategy.load(std::memory_order_acquire);
+    if (borrowed)
+        return investWith(*borrowed, amount);
+    return InvestmentResult::failure(StatusNoStrategy);
+}
+
+// The amount is checked before reserving: reserving a negative amount would briefly raise the
+// balance, and a concurrent withdrawal could spend it before the release
+InvestmentResult Bank::investWith(const InvestmentStrategy& current, double amount) {
+    if (!(amount > 0)) {
+        INVESTMENT_METRIC_COUNT(MetricInvalidAmount);
+        return InvestmentResult::failure(StatusInvalidAmount);
+    }
+    if (!reserveFunds(amount)) {
+        INVESTMENT_METRIC_COUNT(MetricInsufficientFunds);
+        return InvestmentResult::failure(StatusInsufficientFunds);
+    }
+    InvestmentResult result;
+    try {
+        result = current.tryInvest(amount);
+    } catch (...) {
+        releaseFunds(amount);
+        throw;
+    }
+    if (!result.ok())
+        releaseFunds(amount);
+    return result;
 }
 
 std::string Bank::getCurrentStrategyName() const {
-    if (!strategy)
+    const InvestmentStrategy* borrowed = borrowedStrategy.load();
+    if (borrowed)
+        return borrowed->getStrategyName();
+    std::shared_ptr<InvestmentStrategy> current = std::atomic_load(&strategy);
+    if (!current)
         return "No strategy set";
-    return strategy->getStrategyName();
+    return current->getStrategyName();
 }
 
 std::string Bank::getName() const {
@@ -36,28 +182,180 @@ void Bank::setName(const std::string& bankName) {
 }
 
 double Bank::getAvailableFunds() const {
-    return availableFunds;
+    return availableFunds.load();
 }
 
 void Bank::depositFunds(double amount) {
-    if (amount <= 0)
-        throw InvestmentException("Deposit amount must be positive");
-    availableFunds += amount;
+    InvestmentStatus status = tryDepositFunds(amount);
+    if (status != StatusOk)
+        throwInvestmentStatus(status);
 }
 
 bool Bank::withdrawFunds(double amount) {
-    if (amount <= 0)
-        throw InvestmentException("Withdrawal amount must be positive");
-    if (amount > availableFunds)
-        return false;
-    availableFunds -= amount;
-    return true;
+    InvestmentStatus status = tryWithdrawFunds(amount);
+    if (status == StatusInvalidWithdrawal)
+        throwInvestmentStatus(status);
+    return status == StatusOk;
+}
+
+InvestmentStatus Bank::tryDepositFunds(double amount) {
+    INVESTMENT_METRIC_COUNT(MetricBankDeposits);
+    if (amount <= 0) {
+        INVESTMENT_METRIC_COUNT(MetricInvalidAmount);
+        return StatusInvalidDeposit;
+    }
+    releaseFunds(amount);
+    return StatusOk;
+}
+
+InvestmentStatus Bank::tryWithdrawFunds(double amount) {
+    INVESTMENT_METRIC_COUNT(MetricBankWithdrawals);
+    if (amount <= 0) {
+        INVESTMENT_METRIC_COUNT(MetricInvalidAmount);
+        return StatusInvalidWithdrawal;
+    }
+    if (!reserveFunds(amount)) {
+        INVESTMENT_METRIC_COUNT(MetricWithdrawalsDeclined);
+        return StatusInsufficientFunds;
+    }
+    return StatusOk;
 }
 
 std::string Bank::getDetails() const {
-    std::stringstream ss;
-    ss << "Bank: " << name << "\n"
-       << "Available Funds: $" << availableFunds << "\n"
-       << "Current Strategy: " << getCurrentStrategyName();
-    return ss.str();
+    std::string details;
+    details.reserve(96);
+    appendDetails(details);
+    return details;
+}
+
+void Bank::appendDetails(std::string& out) const {
+    out += "Bank: ";
+    out += name;
+    out += "\nAvailable Funds: $";
+    appendNumber(out, getAvailableFunds());
+    out += "\nCurrent Strategy: ";
+    std::shared_ptr<const InvestmentStrategy> current = getStrategy();
+    if (current)
+        out += current->getStrategyName();
+    else
+        out += "No strategy set";
+}
+
+std::size_t Bank::applyOperations(Bank* banks, std::size_t bankCount, const BankOperation* operations,
+                                  std::size_t count, InvestmentStatus* statuses, double* values) {
+    if (count == 0)
+        return 0;
+    if (!banks || !operations || !statuses || !values)
+        throw InvestmentException("Batch buffers cannot be null");
+    // Reject a bad batch before any bank is touched
+    bool malformed = false;
+    for (std::size_t i = 0; i < count; ++i)
+        malformed |= (operations[i].bank >= bankCount) | (operations[i].type > OperationInvestment);
+    if (malformed)
+        throw InvestmentException("Batch contains an invalid bank operation");
+
+    // Operations go through in blocks, so the scratch buffers stay small and cache-resident
+    const std::size_t blockSize = 1024;
+    const std::size_t linearGroups = 16;
+    static const double fundsSign[3] = {1.0, -1.0, -1.0};
+    std::vector<std::size_t> investments(blockSize + 1);
+    std::vector<const InvestmentStrategy*> investedWith(blockSize + 1);
+    std::vector<std::uint32_t> groupOf(blockSize);
+    std::vector<std::size_t> order(blockSize);
+    std::vector<double> amounts(blockSize);
+    std::vector<double> results(blockSize);
+    std::vector<const InvestmentStrategy*> groups;
+    std::vector<std::size_t> offsets;
+    std::unordered_map<const InvestmentStrategy*, std::uint32_t> groupIndex;
+    std::vector<std::size_t> failed;
+    std::size_t succeeded = 0;
+    std::size_t failures = 0;
+    for (std::size_t blockStart = 0; blockStart < count; blockStart += blockSize) {
+        const std::size_t blockEnd = std::min(count, blockStart + blockSize);
+
+        // Funds pass: table lookups and selects instead of data-dependent branches
+        std::size_t accepted = 0;
+        for (std::size_t i = blockStart; i < blockEnd; ++i) {
+            const BankOperation& operation = operations[i];
+            Bank& bank = banks[operation.bank];
+            const double amount = operation.amount;
+            const double balance = bank.availableFunds.load(std::memory_order_relaxed);
+            const InvestmentStrategy* borrowed = bank.borrowedStrategy.load(std::memory_order_relaxed);
+            const InvestmentStrategy* current = borrowed ? borrowed : bank.strategy.get();
+            // tryExecuteInvestment also rejects a NaN amount as invalid
+            const bool nonPositive = (amount <= 0) | ((operation.type == OperationInvestment) & (amount != amount));
+            const InvestmentStatus status = operationStatuses.lookup(operation.type, nonPositive, amount <= balance,
+                                                                     current != nullptr);
+            const bool ok = status == StatusOk;
+            const double candidates[2] = {balance, balance + fundsSign[operation.type] * amount};
+            const double updated = candidates[ok];
+            bank.availableFunds.store(updated, std::memory_order_relaxed);
+            statuses[i] = status;
+            values[i] = updated;
+            succeeded += ok;
+            // Written every time and kept only for accepted investments; the spare slot absorbs the rest
+            investments[accepted] = i;
+            investedWith[accepted] = current;
+            accepted += ok & (operation.type == OperationInvestment);
+        }
+        if (accepted == 0)
+            continue;
+
+        // Group by strategy: a linear scan while there are few strategies, a hash lookup beyond that
+        groups.clear();
+        groupIndex.clear();
+        for (std::size_t j = 0; j < accepted; ++j) {
+            const InvestmentStrategy* current = investedWith[j];
+            std::uint32_t group = 0;
+            while (group < groups.size() && group < linearGroups && groups[group] != current)
+                ++group;
+            if (group == linearGroups) {
+                if (groupIndex.empty())
+                    for (std::uint32_t g = 0; g < linearGroups; ++g)
+                        groupIndex[groups[g]] = g;
+                group = groupIndex.insert(std::make_pair(current, static_cast<std::uint32_t>(groups.size()))).first->second;
+            }
+            if (group == groups.size())
+                groups.push_back(current);
+            groupOf[j] = group;
+        }
+
+        // Counting sort by group keeps each group in submission order
+        offsets.assign(groups.size() + 1, 0);
+        for (std::size_t j = 0; j < accepted; ++j)
+            ++offsets[groupOf[j] + 1];
+        for (std::size_t g = 0; g < groups.size(); ++g)
+            offsets[g + 1] += offsets[g];
+        for (std::size_t j = 0; j < accepted; ++j) {
+            const std::size_t slot = offsets[groupOf[j]]++;
+            order[slot] = investments[j];
+            amounts[slot] = operations[investments[j]].amount;
+        }
+        // Each offset now holds the end of its group
+        std::size_t first = 0;
+        for (std::size_t g = 0; g < groups.size(); ++g) {
+            const std::size_t last = offsets[g];
+            try {
+                groups[g]->investBatch(amounts.data() + first, results.data() + first, last - first);
+                for (std::size_t j = first; j < last; ++j)
+                    values[order[j]] = results[j];
+            } catch (...) {
+                failed.insert(failed.end(), order.begin() + first, order.begin() + last);
+            }
+            first = last;
+        }
+
+        // Refund before the next block, so its funds checks see the returned funds
+        for (std::size_t i = 0; i < failed.size(); ++i) {
+            const std::size_t index = failed[i];
+            Bank& bank = banks[operations[index].bank];
+            const double restored = bank.availableFunds.load(std::memory_order_relaxed) + operations[index].amount;
+            bank.availableFunds.store(restored, std::memory_order_relaxed);
+            statuses[index] = StatusStrategyFailed;
+            values[index] = restored;
+        }
+        failures += failed.size();
+        failed.clear();
+    }
+    return succeeded - failures;
 }
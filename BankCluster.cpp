@@ -0,0 +1,329 @@
+#include "BankCluster.h"
+#include <algorithm>
+#include <exception>
+
+namespace {
+
+ClusterStats emptyStats() {
+    ClusterStats stats;
+    stats.messages = 0;
+    stats.investments = 0;
+    stats.rejected = 0;
+    stats.transfers = 0;
+    stats.transfersDeclined = 0;
+    stats.investedValue = 0.0;
+    return stats;
+}
+
+// Runs on a shard thread, where an escaping exception would terminate the process; a strategy
+// that throws is counted as a rejection instead
+InvestmentResult investOnShard(Bank& bank, double amount) {
+    try {
+        return bank.tryExecuteInvestment(amount);
+    } catch (...) {
+        return InvestmentResult::failure(StatusStrategyFailed);
+    }
+}
+
+void recordInvestment(ClusterStats& counters, const InvestmentResult& result) {
+    if (result.ok()) {
+        ++counters.investments;
+        counters.investedValue += result.value;
+    } else {
+        ++counters.rejected;
+    }
+}
+
+} // namespace
+
+BankCluster::BankCluster(std::size_t shardCount) : nextBank(0), outstanding(0) {
+    if (shardCount == 0)
+        shardCount = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t i = 0; i < shardCount; ++i) {
+        shards.push_back(std::unique_ptr<Shard>(new Shard()));
+        shards.back()->sleeping = false;
+        shards.back()->stopping = false;
+        shards.back()->counters = emptyStats();
+    }
+    for (auto& shard : shards)
+        shard->thread = std::thread(&BankCluster::run, this, std::ref(*shard));
+}
+
+BankCluster::~BankCluster() {
+    quiesce();
+    for (auto& shard : shards) {
+        {
+            std::lock_guard<std::mutex> lock(shard->mutex);
+            shard->stopping = true;
+        }
+        shard->wake.notify_one();
+        shard->thread.join();
+    }
+}
+
+std::size_t BankCluster::shardCount() const {
+    return shards.size();
+}
+
+std::size_t BankCluster::bankCount() const {
+    return nextBank.load();
+}
+
+void BankCluster::checkBank(BankId bank) const {
+    if (bank >= nextBank.load())
+        throw InvestmentException("Unknown bank");
+}
+
+void BankCluster::post(std::size_t index, Message& message) {
+    outstanding.fetch_add(1);
+    Shard& shard = *shards[index];
+    bool sleeping;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.inbox.push_back(std::move(message));
+        sleeping = shard.sleeping;
+        shard.sleeping = false;
+    }
+    if (sleeping)
+        shard.wake.notify_one();
+}
+
+void BankCluster::post(Message::Type type, BankId bank, BankId target, double amount) {
+    Message message;
+    message.type = type;
+    message.bank = bank;
+    message.target = target;
+    message.amount = amount;
+    post(bank % shards.size(), message);
+}
+
+BankId BankCluster::addBank(const std::string& name, double initialFunds) {
+    if (initialFunds < 0.0)
+        throw InvestmentException("Initial funds cannot be negative");
+    std::lock_guard<std::mutex> lock(addMutex);
+    const BankId id = nextBank.load();
+    Shard* shard = shards[id % shards.size()].get();
+    const std::size_t local = id / shards.size();
+    Message message;
+    message.type = Message::Task;
+    message.task = [shard, local, name, initialFunds] {
+        if (shard->banks.size() <= local)
+            shard->banks.resize(local + 1);
+        shard->banks[local].reset(new Bank(name, initialFunds));
+    };
+    post(id % shards.size(), message);
+    nextBank.store(id + 1);
+    return id;
+}
+
+void BankCluster::deposit(BankId bank, double amount) {
+    checkBank(bank);
+    post(Message::Deposit, bank, bank, amount);
+}
+
+void BankCluster::withdraw(BankId bank, double amount) {
+    checkBank(bank);
+    post(Message::Withdraw, bank, bank, amount);
+}
+
+void BankCluster::invest(BankId bank, double amount) {
+    checkBank(bank);
+    post(Message::Invest, bank, bank, amount);
+}
+
+void BankCluster::transfer(BankId from, BankId to, double amount) {
+    checkBank(from);
+    checkBank(to);
+    if (amount <= 0)
+        throw InvestmentException("Transfer amount must be positive");
+    post(Message::TransferOut, from, to, amount);
+}
+
+// Drains the inbox a batch at a time, so producers contend for the lock once per batch rather
+// than once per message
+void BankCluster::run(Shard& shard) {
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(shard.mutex);
+            while (shard.inbox.empty() && !shard.stopping) {
+                shard.sleeping = true;
+                shard.wake.wait(lock);
+            }
+            shard.sleeping = false;
+            if (shard.inbox.empty())
+                return;
+            shard.processing.swap(shard.inbox);
+        }
+        for (Message& message : shard.processing)
+            apply(shard, message);
+        const std::size_t done = shard.processing.size();
+        shard.processing.clear();
+        if (outstanding.fetch_sub(done) == done) {
+            std::lock_guard<std::mutex> lock(idleMutex);
+            idle.notify_all();
+        }
+    }
+}
+
+Bank* BankCluster::find(Shard& shard, BankId bank) {
+    return shard.banks[bank / shards.size()].get();
+}
+
+void BankCluster::apply(Shard& shard, Message& message) {
+    ClusterStats& counters = shard.counters;
+    if (message.type == Message::Task) {
+        message.task();
+        return;
+    }
+    ++counters.messages;
+    Bank* bank = find(shard, message.bank);
+    switch (message.type) {
+    case Message::Deposit:
+        if (bank->tryDepositFunds(message.amount) != StatusOk)
+            ++counters.rejected;
+        break;
+    case Message::Withdraw:
+        if (bank->tryWithdrawFunds(message.amount) != StatusOk)
+            ++counters.rejected;
+        break;
+    case Message::Invest:
+        recordInvestment(counters, investOnShard(*bank, message.amount));
+        break;
+    case Message::TransferOut:
+        if (bank->tryWithdrawFunds(message.amount) != StatusOk) {
+            ++counters.transfersDeclined;
+        } else if (message.target % shards.size() == message.bank % shards.size()) {
+            find(shard, message.target)->depositFunds(message.amount);
+            ++counters.transfers;
+        } else {
+            post(Message::TransferIn, message.target, message.target, message.amount);
+        }
+        break;
+    case Message::TransferIn:
+        bank->depositFunds(message.amount);
+        ++counters.transfers;
+        break;
+    case Message::Task:
+        break;
+    }
+}
+
+void BankCluster::runOnShards(std::size_t first, std::size_t last, const std::function<void(std::size_t shard)>& fn) {
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t remaining = last - first;
+    std::exception_ptr error;
+    for (std::size_t i = first; i < last; ++i) {
+        Message message;
+        message.type = Message::Task;
+        message.task = [&, i] {
+            std::exception_ptr thrown;
+            try {
+                fn(i);
+            } catch (...) {
+                thrown = std::current_exception();
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            if (thrown && !error)
+                error = thrown;
+            if (--remaining == 0)
+                done.notify_one();
+        };
+        post(i, message);
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return remaining == 0; });
+    if (error)
+        std::rethrow_exception(error);
+}
+
+std::size_t BankCluster::setStrategyWhere(std::shared_ptr<InvestmentStrategy> strategy, const BankPredicate& predicate) {
+    std::vector<std::size_t> matched(shards.size(), 0);
+    runOnShards(0, shards.size(), [&](std::size_t index) {
+        for (auto& bank : shards[index]->banks) {
+            if (bank && predicate(*bank)) {
+                bank->setStrategy(strategy);
+                ++matched[index];
+            }
+        }
+    });
+    std::size_t total = 0;
+    for (std::size_t count : matched)
+        total += count;
+    return total;
+}
+
+std::size_t BankCluster::investWhere(double amount, const BankPredicate& predicate) {
+    std::vector<std::size_t> matched(shards.size(), 0);
+    runOnShards(0, shards.size(), [&](std::size_t index) {
+        Shard& shard = *shards[index];
+        for (auto& bank : shard.banks) {
+            if (bank && predicate(*bank)) {
+                ++shard.counters.messages;
+                recordInvestment(shard.counters, investOnShard(*bank, amount));
+                ++matched[index];
+            }
+        }
+    });
+    std::size_t total = 0;
+    for (std::size_t count : matched)
+        total += count;
+    return total;
+}
+
+void BankCluster::forEachBank(const std::function<void(Bank& bank)>& fn) {
+    runOnShards(0, shards.size(), [&](std::size_t index) {
+        for (auto& bank : shards[index]->banks) {
+            if (bank)
+                fn(*bank);
+        }
+    });
+}
+
+double BankCluster::availableFunds(BankId bank) {
+    checkBank(bank);
+    const std::size_t index = bank % shards.size();
+    double funds = 0.0;
+    runOnShards(index, index + 1, [&](std::size_t) {
+        funds = find(*shards[index], bank)->getAvailableFunds();
+    });
+    return funds;
+}
+
+double BankCluster::totalFunds() {
+    std::vector<double> sums(shards.size(), 0.0);
+    runOnShards(0, shards.size(), [&](std::size_t index) {
+        double sum = 0.0;
+        for (auto& bank : shards[index]->banks) {
+            if (bank)
+                sum += bank->getAvailableFunds();
+        }
+        sums[index] = sum;
+    });
+    double total = 0.0;
+    for (double sum : sums)
+        total += sum;
+    return total;
+}
+
+ClusterStats BankCluster::stats() {
+    std::vector<ClusterStats> perShard(shards.size());
+    runOnShards(0, shards.size(), [&](std::size_t index) {
+        perShard[index] = shards[index]->counters;
+    });
+    ClusterStats total = emptyStats();
+    for (const ClusterStats& shard : perShard) {
+        total.messages += shard.messages;
+        total.investments += shard.investments;
+        total.rejected += shard.rejected;
+        total.transfers += shard.transfers;
+        total.transfersDeclined += shard.transfersDeclined;
+        total.investedValue += shard.investedValue;
+    }
+    return total;
+}
+
+void BankCluster::quiesce() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    idle.wait(lock, [this] { return outstanding.load() == 0; });
+}
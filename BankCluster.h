@@ -0,0 +1,111 @@
+#ifndef BANK_CLUSTER_H
+#define BANK_CLUSTER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+typedef std::size_t BankId;
+// Runs on the shard threads, several at once; must only read the bank and shared state
+typedef std::function<bool(const Bank& bank)> BankPredicate;
+
+struct ClusterStats {
+    std::uint64_t messages;             // operations processed by the shards
+    std::uint64_t investments;
+    std::uint64_t rejected;             // deposits, withdrawals and investments not StatusOk, including
+                                        // investments whose strategy threw
+    std::uint64_t transfers;
+    std::uint64_t transfersDeclined;    // the source bank could not cover the amount
+    double investedValue;               // sum of investment results
+};
+
+// Banks sharded across worker threads with shared-nothing ownership: bank id % shardCount picks
+// the shard, and only that shard's thread ever touches the bank. Every operation is a message to
+// the owning shard's queue and is applied in the order it was posted from any one thread.
+// Transfers debit the source on its shard, then post the credit to the destination's shard, so
+// funds are briefly in flight; quiesce() waits until none are. Bulk operations run on all shards
+// in parallel and see everything posted before them, except credits still in flight. Blocking
+// calls must not be made from code running on a shard (predicates, forEachBank).
+class BankCluster {
+public:
+    explicit BankCluster(std::size_t shards = 0);   // 0 = hardware concurrency
+    ~BankCluster();
+
+    BankCluster(const BankCluster&) = delete;
+    BankCluster& operator=(const BankCluster&) = delete;
+
+    std::size_t shardCount() const;
+    std::size_t bankCount() const;
+
+    // Asynchronous; rejections are counted in stats()
+    BankId addBank(const std::string& name, double initialFunds = 0.0);
+    void deposit(BankId bank, double amount);
+    void withdraw(BankId bank, double amount);
+    void invest(BankId bank, double amount);
+    void transfer(BankId from, BankId to, double amount);
+
+    // Blocking bulk operations; each returns the number of banks the predicate matched
+    std::size_t setStrategyWhere(std::shared_ptr<InvestmentStrategy> strategy, const BankPredicate& predicate);
+    std::size_t investWhere(double amount, const BankPredicate& predicate);
+    // fn runs on the shard threads, several at once
+    void forEachBank(const std::function<void(Bank& bank)>& fn);
+
+    double availableFunds(BankId bank);
+    // Summed per shard, then across shards in shard order
+    double totalFunds();
+    ClusterStats stats();
+
+    // Waits until every posted operation, including transfer credits, has been applied
+    void quiesce();
+
+private:
+    struct Message {
+        enum Type { Deposit, Withdraw, Invest, TransferOut, TransferIn, Task } type;
+        BankId bank;
+        BankId target;
+        double amount;
+        std::function<void()> task;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::vector<Message> inbox;
+        bool sleeping;
+        bool stopping;
+
+        // Owned by the shard thread
+        std::vector<std::unique_ptr<Bank> > banks;  // indexed by id / shardCount
+        std::vector<Message> processing;
+        ClusterStats counters;
+        std::thread thread;
+    };
+
+    void post(std::size_t shard, Message& message);
+    void post(Message::Type type, BankId bank, BankId target, double amount);
+    void run(Shard& shard);
+    void apply(Shard& shard, Message& message);
+    Bank* find(Shard& shard, BankId bank);
+    // Runs fn(shard index) on the threads of shards [first, last) and waits for all of them
+    void runOnShards(std::size_t first, std::size_t last, const std::function<void(std::size_t shard)>& fn);
+    void checkBank(BankId bank) const;
+
+    std::vector<std::unique_ptr<Shard> > shards;
+    // An id is published by nextBank only after its creation is queued; addMutex keeps the
+    // allocation and the publication in id order
+    std::mutex addMutex;
+    std::atomic<std::size_t> nextBank;
+    std::atomic<std::size_t> outstanding;       // posted messages not yet applied
+    std::mutex idleMutex;
+    std::condition_variable idle;
+};
+
+#endif // BANK_CLUSTER_H
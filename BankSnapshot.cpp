@@ -0,0 +1,164 @@
+#include "BankSnapshot.h"
+#include "DurableFile.h"
+#include "MappedFile.h"
+#include "StrategyRecord.h"
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+
+namespace {
+
+const char bankSnapshotMagic[8] = {'I', 'N', 'V', 'B', 'N', 'K', '0', '1'};
+const std::uint32_t bankSnapshotVersion = 1;
+
+BankSnapshotStrategy encodeStrategy(const InvestmentStrategy& strategy, std::string& names) {
+    BankSnapshotStrategy record;
+    std::memset(&record, 0, sizeof(record));
+    std::string name;
+    encodeStrategyRecord(strategy, record, name);
+    if (names.size() + name.size() > 0xFFFFFFFFu)
+        throw InvestmentException("Too many strategy names for a bank snapshot");
+    record.nameOffset = static_cast<std::uint32_t>(names.size());
+    record.nameLength = static_cast<std::uint32_t>(name.size());
+    names += name;
+    return record;
+}
+
+// Appends to a per-type array reserved up front, so the aliasing pointers stay valid
+template <typename Strategy>
+std::shared_ptr<InvestmentStrategy> share(const std::shared_ptr<std::vector<Strategy> >& store) {
+    return std::shared_ptr<InvestmentStrategy>(store, &store->back());
+}
+
+} // namespace
+
+void saveBankSnapshot(const std::string& path, const std::vector<Bank>& banks) {
+    saveBankSnapshot(path, banks.data(), banks.size());
+}
+
+void saveBankSnapshot(const std::string& path, const Bank* banks, std::size_t count) {
+    std::vector<BankSnapshotStrategy> strategies;
+    std::vector<BankSnapshotRecord> records(count);
+    std::string names;
+    std::unordered_map<const InvestmentStrategy*, std::uint32_t> strategyIndex;
+    for (std::size_t i = 0; i < count; ++i) {
+        BankSnapshotRecord& record = records[i];
+        record.strategy = BankSnapshotNoStrategy;
+        std::shared_ptr<const InvestmentStrategy> strategy = banks[i].getStrategy();
+        if (strategy) {
+            auto found = strategyIndex.find(strategy.get());
+            if (found == strategyIndex.end()) {
+                if (strategies.size() >= BankSnapshotNoStrategy)
+                    throw InvestmentException("Too many strategies for a bank snapshot");
+                found = strategyIndex.insert(std::make_pair(strategy.get(), static_cast<std::uint32_t>(strategies.size()))).first;
+                strategies.push_back(encodeStrategy(*strategy, names));
+            }
+            record.strategy = found->second;
+        }
+        const std::string name = banks[i].getName();
+        record.availableFunds = banks[i].getAvailableFunds();
+        record.nameOffset = names.size();
+        record.nameLength = static_cast<std::uint32_t>(name.size());
+        names += name;
+    }
+
+    BankSnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, bankSnapshotMagic, sizeof(header.magic));
+    header.version = bankSnapshotVersion;
+    header.bankCount = count;
+    header.strategyCount = strategies.size();
+    header.nameBytes = names.size();
+
+    const std::string temporary = path + ".tmp";
+    int out = openFile(temporary, true);
+    if (out < 0)
+        throw InvestmentException("Cannot create bank snapshot: " + temporary);
+    bool ok = writeAll(out, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+              writeAll(out, reinterpret_cast<const char*>(strategies.data()), strategies.size() * sizeof(BankSnapshotStrategy)) &&
+              writeAll(out, reinterpret_cast<const char*>(records.data()), records.size() * sizeof(BankSnapshotRecord)) &&
+              writeAll(out, names.data(), names.size()) && syncFile(out);
+    closeFile(out);
+    if (!ok || !replaceFile(temporary, path))
+        throw InvestmentException("Cannot write bank snapshot: " + path);
+}
+
+std::vector<Bank> loadBankSnapshot(const std::string& path) {
+    MappedFile file(path);
+    const unsigned char* bytes = file.data();
+    BankSnapshotHeader header;
+    if (file.size() < sizeof(header))
+        throw InvestmentException("Bank snapshot is truncated: " + path);
+    std::memcpy(&header, bytes, sizeof(header));
+    if (std::memcmp(header.magic, bankSnapshotMagic, sizeof(header.magic)) != 0)
+        throw InvestmentException("Not a bank snapshot: " + path);
+    if (header.version != bankSnapshotVersion)
+        throw InvestmentException("Unsupported bank snapshot version: " + path);
+    // Each count is bounded by the file size before it is multiplied, so the sum cannot overflow
+    const std::uint64_t available = file.size() - sizeof(header);
+    if (header.strategyCount > available / sizeof(BankSnapshotStrategy) ||
+        header.bankCount > available / sizeof(BankSnapshotRecord) || header.nameBytes > available ||
+        header.strategyCount * sizeof(BankSnapshotStrategy) + header.bankCount * sizeof(BankSnapshotRecord) +
+            header.nameBytes != available)
+        throw InvestmentException("Bank snapshot is corrupt: " + path);
+
+    const std::size_t strategyCount = static_cast<std::size_t>(header.strategyCount);
+    const std::size_t bankCount = static_cast<std::size_t>(header.bankCount);
+    const BankSnapshotStrategy* strategyRecords = reinterpret_cast<const BankSnapshotStrategy*>(bytes + sizeof(header));
+    const BankSnapshotRecord* bankRecords = reinterpret_cast<const BankSnapshotRecord*>(strategyRecords + strategyCount);
+    const char* names = reinterpret_cast<const char*>(bankRecords + bankCount);
+
+    std::size_t kindCounts[4] = {0, 0, 0, 0};
+    for (std::size_t i = 0; i < strategyCount; ++i) {
+        const BankSnapshotStrategy& record = strategyRecords[i];
+        if (record.kind > StrategyRecordCrypto ||
+            static_cast<std::uint64_t>(record.nameOffset) + record.nameLength > header.nameBytes)
+            throw InvestmentException("Bank snapshot is corrupt: " + path);
+        ++kindCounts[record.kind];
+    }
+
+    std::shared_ptr<std::vector<InvestmentStrategy> > bases = std::make_shared<std::vector<InvestmentStrategy> >();
+    std::shared_ptr<std::vector<StockInvestment> > stocks = std::make_shared<std::vector<StockInvestment> >();
+    std::shared_ptr<std::vector<BondInvestment> > bonds = std::make_shared<std::vector<BondInvestment> >();
+    std::shared_ptr<std::vector<CryptoInvestment> > cryptos = std::make_shared<std::vector<CryptoInvestment> >();
+    bases->reserve(kindCounts[StrategyRecordBase]);
+    stocks->reserve(kindCounts[StrategyRecordStock]);
+    bonds->reserve(kindCounts[StrategyRecordBond]);
+    cryptos->reserve(kindCounts[StrategyRecordCrypto]);
+
+    std::vector<std::shared_ptr<InvestmentStrategy> > strategies(strategyCount);
+    for (std::size_t i = 0; i < strategyCount; ++i) {
+        const BankSnapshotStrategy& record = strategyRecords[i];
+        const std::string name(names + record.nameOffset, record.nameLength);
+        switch (record.kind) {
+        case StrategyRecordStock:
+            stocks->push_back(decodeStockRecord(record));
+            strategies[i] = share(stocks);
+            break;
+        case StrategyRecordBond:
+            bonds->push_back(decodeBondRecord(record));
+            strategies[i] = share(bonds);
+            break;
+        case StrategyRecordCrypto:
+            cryptos->push_back(decodeCryptoRecord(record, name));
+            strategies[i] = share(cryptos);
+            break;
+        default:
+            bases->emplace_back(name, record.riskRating);
+            strategies[i] = share(bases);
+            break;
+        }
+    }
+
+    std::vector<Bank> banks;
+    banks.reserve(bankCount);
+    for (std::size_t i = 0; i < bankCount; ++i) {
+        const BankSnapshotRecord& record = bankRecords[i];
+        if (record.nameOffset > header.nameBytes || record.nameLength > header.nameBytes - record.nameOffset ||
+            (record.strategy != BankSnapshotNoStrategy && record.strategy >= strategyCount))
+            throw InvestmentException("Bank snapshot is corrupt: " + path);
+        banks.emplace_back(std::string(names + record.nameOffset, record.nameLength), record.availableFunds,
+                           record.strategy == BankSnapshotNoStrategy ? nullptr : strategies[record.strategy]);
+    }
+    return banks;
+}
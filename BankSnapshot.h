@@ -0,0 +1,64 @@
+#ifndef BANK_SNAPSHOT_H
+#define BANK_SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+// Binary snapshot of many banks, in host (little-endian) byte order:
+//   BankSnapshotHeader
+//   strategyCount BankSnapshotStrategy records (each strategy shared by several banks is stored once)
+//   bankCount BankSnapshotRecord records
+//   nameBytes of names, referenced by offset from the records
+// Like position files, the bulk data carries no checksum; loading checks the structure (sizes,
+// offsets, strategy indices) and the strategy constructors check the parameters.
+
+struct BankSnapshotHeader {
+    char magic[8];              // "INVBNK01"
+    std::uint32_t version;
+    std::uint32_t reserved;
+    std::uint64_t bankCount;
+    std::uint64_t strategyCount;
+    std::uint64_t nameBytes;
+    std::uint64_t reserved2;
+};
+
+// Strategy fields as StrategyRecord.h encodes them
+struct BankSnapshotStrategy {
+    std::uint8_t kind;          // StrategyRecordKind
+    std::uint8_t callable;
+    std::uint16_t reserved;
+    std::int32_t termYears;
+    std::uint32_t nameOffset;
+    std::uint32_t nameLength;
+    double riskRating;
+    double params[5];
+};
+
+const std::uint32_t BankSnapshotNoStrategy = 0xFFFFFFFFu;
+
+struct BankSnapshotRecord {
+    double availableFunds;
+    std::uint64_t nameOffset;
+    std::uint32_t nameLength;
+    std::uint32_t strategy;     // index into the strategy table, or BankSnapshotNoStrategy
+};
+
+static_assert(sizeof(BankSnapshotHeader) == 48, "BankSnapshotHeader layout changed");
+static_assert(sizeof(BankSnapshotStrategy) == 64, "BankSnapshotStrategy layout changed");
+static_assert(sizeof(BankSnapshotRecord) == 24, "BankSnapshotRecord layout changed");
+
+// Writes a temporary file and renames it over path, so a crash mid-save keeps the old snapshot.
+// Borrowed strategies are saved like owned ones and come back owned. Throws before writing
+// anything if a strategy's type cannot be recorded, such as a subclass of a built-in strategy.
+void saveBankSnapshot(const std::string& path, const std::vector<Bank>& banks);
+void saveBankSnapshot(const std::string& path, const Bank* banks, std::size_t count);
+
+// Maps the file and rebuilds every bank in one pass. Strategies are constructed by concrete type
+// into one array per type and shared by the banks that referenced them, so there is one
+// allocation per type rather than per strategy.
+std::vector<Bank> loadBankSnapshot(const std::string& path);
+
+#endif // BANK_SNAPSHOT_H
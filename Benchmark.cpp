@@ -0,0 +1,1152 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <sstream>
+#include <vector>
+#include "InvestmentSimulator.h"
+#include "BenchmarkHarness.h"
+#include "ThreadPool.h"
+#include "Portfolio.h"
+#include "ScenarioGrid.h"
+#include "StrategyKernels.h"
+#include "PositionFile.h"
+#include "CounterRng.h"
+#include "PeriodSimulation.h"
+#include "RebalancingBank.h"
+#include "StrategyCache.h"
+#include "Metrics.h"
+#include "StrategyArena.h"
+#include "JournaledBank.h"
+#include "InvestmentPipeline.h"
+#include "RiskAggregator.h"
+#include "BankCluster.h"
+#include "Sensitivity.h"
+#include "BankSnapshot.h"
+#include "YieldCurve.h"
+
+namespace {
+
+volatile double sink = 0.0;
+volatile std::size_t sizeSink = 0;
+
+std::vector<double> makeAmounts(std::size_t n) {
+    std::vector<double> amounts(n);
+    for (std::size_t i = 0; i < n; ++i)
+        amounts[i] = 100.0 + static_cast<double>(i % 1000);
+    return amounts;
+}
+
+std::vector<std::shared_ptr<InvestmentStrategy> > sampleStrategies() {
+    std::vector<std::shared_ptr<InvestmentStrategy> > strategies;
+    strategies.push_back(std::make_shared<InvestmentStrategy>("Base", 0.0));
+    strategies.push_back(std::make_shared<StockInvestment>(0.5, 0.15, 0.2, 0.03));
+    strategies.push_back(std::make_shared<BondInvestment>(0.05, 5, 0.02, true));
+    return strategies;
+}
+
+void benchStrategies(BenchmarkHarness& h) {
+    const std::size_t n = 1 << 20;
+    std::vector<double> amounts = makeAmounts(n);
+    for (const auto& strategy : sampleStrategies()) {
+        const InvestmentStrategy* s = strategy.get();
+        const std::string name = s->getStrategyName();
+        h.measure(name + " invest", n, [&] {
+            double total = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+                total += s->invest(amounts[i]);
+            sink = total;
+        });
+        h.measure(name + " calculatePotentialReturn", n, [&] {
+            double total = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+                total += s->calculatePotentialReturn(amounts[i]);
+            sink = total;
+        });
+        h.measure(name + " calculateRisk", n, [&] {
+            double total = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+                total += s->calculateRisk();
+            sink = total;
+        });
+    }
+}
+
+void benchInvestBatch(BenchmarkHarness& h) {
+    const std::size_t n = 1 << 20;
+    std::vector<double> amounts = makeAmounts(n);
+    std::vector<double> out(n);
+    for (const auto& strategy : sampleStrategies()) {
+        const InvestmentStrategy* s = strategy.get();
+        h.measure(s->getStrategyName() + " invest (scalar loop)", n, [&] {
+            for (std::size_t i = 0; i < n; ++i)
+                out[i] = s->invest(amounts[i]);
+            sink = out[n - 1];
+        });
+        h.measure(s->getStrategyName() + " investBatch", n, [&] {
+            s->investBatch(amounts.data(), out.data(), n);
+            sink = out[n - 1];
+        });
+    }
+}
+
+void benchBank(BenchmarkHarness& h) {
+    const std::size_t n = 1 << 20;
+    std::vector<double> amounts = makeAmounts(n);
+    for (const auto& strategy : sampleStrategies()) {
+        Bank bank("Benchmark Bank", 1e15);
+        bank.setStrategy(strategy);
+        h.measure("Bank executeInvestment (" + strategy->getStrategyName() + ")", n, [&] {
+            double total = 0.0;
+            for (std::size_t i = 0; i < n; ++i)
+                total += bank.executeInvestment(amounts[i]);
+            sink = total;
+        });
+    }
+    Bank bank("Benchmark Bank", 1e15);
+    h.measure("Bank depositFunds + withdrawFunds", n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            bank.depositFunds(amounts[i]);
+            bank.withdrawFunds(amounts[i]);
+        }
+        sink = bank.getAvailableFunds();
+    });
+}
+
+// 7.5% of requests rejected: 5% invalid amounts, 2.5% more than the bank holds
+void benchRejections(BenchmarkHarness& h) {
+    const std::size_t n = 1 << 18;
+    std::vector<double> amounts = makeAmounts(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint64_t pick = CounterRng::mix(i) % 40;
+        if (pick < 2)
+            amounts[i] = -amounts[i];
+        else if (pick < 3)
+            amounts[i] = 1e18;
+    }
+    Bank bank("Benchmark Bank", 1e15);
+    bank.setStrategy(std::make_shared<StockInvestment>());
+
+    h.measure("executeInvestment, 7.5% rejected, exceptions", n, [&] {
+        double total = 0.0;
+        std::size_t rejected = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            try {
+                total += bank.executeInvestment(amounts[i]);
+            } catch (const InvestmentException&) {
+                ++rejected;
+            }
+        }
+        sink = total + static_cast<double>(rejected);
+    });
+    h.measure("executeInvestment, 7.5% rejected, status codes", n, [&] {
+        double total = 0.0;
+        std::size_t rejected = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            InvestmentResult result = bank.tryExecuteInvestment(amounts[i]);
+            if (result.ok())
+                total += result.value;
+            else
+                ++rejected;
+        }
+        sink = total + static_cast<double>(rejected);
+    });
+    h.measure("withdrawFunds, 7.5% rejected, exceptions", n, [&] {
+        std::size_t rejected = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            try {
+                rejected += bank.withdrawFunds(amounts[i]) ? 0 : 1;
+            } catch (const InvestmentException&) {
+                ++rejected;
+            }
+        }
+        sink = static_cast<double>(rejected);
+    });
+    h.measure("withdrawFunds, 7.5% rejected, status codes", n, [&] {
+        std::size_t rejected = 0;
+        for (std::size_t i = 0; i < n; ++i)
+            rejected += bank.tryWithdrawFunds(amounts[i]) == StatusOk ? 0 : 1;
+        sink = static_cast<double>(rejected);
+    });
+}
+
+void benchDetails(BenchmarkHarness& h) {
+    const std::size_t n = 200000;
+    std::string buffer;
+    buffer.reserve(256);
+    for (const auto& strategy : sampleStrategies()) {
+        const InvestmentStrategy* s = strategy.get();
+        h.measure(s->getStrategyName() + " getInvestmentDetails", n, [&] {
+            for (std::size_t i = 0; i < n; ++i)
+                sizeSink = s->getInvestmentDetails(100.0 + i).size();
+        });
+        h.measure(s->getStrategyName() + " appendInvestmentDetails (reused buffer)", n, [&] {
+            for (std::size_t i = 0; i < n; ++i) {
+                buffer.clear();
+                s->appendInvestmentDetails(buffer, 100.0 + i);
+                sizeSink = buffer.size();
+            }
+        });
+    }
+    h.measure("Bond details via stringstream (pre-appendInvestmentDetails reference)", n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            std::stringstream ss;
+            ss << "Investing $" << 100.0 + i << " using Bond strategy (Risk rating: " << 0.2 << ")"
+               << " with " << 6.0 << "% nominal interest over " << 7 << " years, Inflation Rate: " << 2.5
+               << "%, Callable: Yes, Callable Adjustment: " << 0.9 << ", Base Risk Weight: " << 0.8
+               << ", Inflation Adjustment: " << 1.0;
+            sizeSink = ss.str().size();
+        }
+    });
+
+    Bank bank("Benchmark Bank", 15000.0);
+    bank.setStrategy(std::make_shared<BondInvestment>());
+    h.measure("Bank getDetails", n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            sizeSink = bank.getDetails().size();
+    });
+    h.measure("Bank appendDetails (reused buffer)", n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            buffer.clear();
+            bank.appendDetails(buffer);
+            sizeSink = buffer.size();
+        }
+    });
+}
+
+void benchMonteCarlo(BenchmarkHarness& h) {
+    StockInvestment stock(0.5, 0.12, 0.25, 0.03);
+    MonteCarloSettings settings(200000, 52, 1.0, 0.95, 1);
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        h.measureRepeated("Stock simulate per path, " + std::to_string(threads) + " threads", settings.paths, 3, [&] {
+            sink = stock.simulate(10000.0, settings, pool).mean;
+        });
+    }
+}
+
+void benchCrypto(BenchmarkHarness& h) {
+    CryptoInvestment crypto("Bitcoin", 0.8, 1.2, 2.0, -0.05, 0.25);
+    const std::size_t paths = 1 << 20;
+    std::vector<double> terminal(paths);
+
+    // Same model drawn one path at a time through libm, as a baseline for the block sampler
+    const double compensator = crypto.getJumpIntensity()
+                             * (std::exp(crypto.getJumpMean() + 0.5 * crypto.getJumpVolatility() * crypto.getJumpVolatility()) - 1.0);
+    const double sigma = crypto.getCryptoVolatility();
+    const double drift = crypto.getDriftRate() - compensator - 0.5 * sigma * sigma;
+    h.measureRepeated("Jump-diffusion per path, scalar libm", paths, 3, [&] {
+        for (std::size_t path = 0; path < paths; ++path) {
+            CounterRng rng(5, path);
+            double logGrowth = drift + sigma * rng.nextNormal();
+            double jumps = 0.0;
+            double threshold = std::exp(-crypto.getJumpIntensity());
+            double probability = threshold;
+            double u = rng.nextUniform();
+            while (u > threshold && jumps < 64.0) {
+                jumps += 1.0;
+                probability *= crypto.getJumpIntensity() / jumps;
+                threshold += probability;
+            }
+            logGrowth += jumps * crypto.getJumpMean() + std::sqrt(jumps) * crypto.getJumpVolatility() * rng.nextNormal();
+            terminal[path] = 10000.0 * std::exp(logGrowth);
+        }
+        sink = terminal[paths - 1];
+    });
+    h.measureRepeated("Jump-diffusion per path, sampleTerminalValues", paths, 3, [&] {
+        crypto.sampleTerminalValues(10000.0, 1.0, 5, 0, terminal.data(), paths);
+        sink = terminal[paths - 1];
+    });
+
+    MonteCarloSettings settings(2000000, 1, 1.0, 0.95, 1);
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        h.measureRepeated("Crypto simulate per path, " + std::to_string(threads) + " threads", settings.paths, 3, [&] {
+            sink = crypto.simulate(10000.0, settings, pool).mean;
+        });
+    }
+}
+
+void benchPortfolio(BenchmarkHarness& h) {
+    const std::size_t positions = 200000;
+    std::vector<std::shared_ptr<InvestmentStrategy> > objects;
+    std::vector<double> amounts;
+    Portfolio portfolio;
+    portfolio.reserve(positions / 2, positions / 2);
+    for (std::size_t i = 0; i < positions; ++i) {
+        double amount = 1000.0 + static_cast<double>(i % 500);
+        if (i % 2 == 0) {
+            auto stock = std::make_shared<StockInvestment>(0.5, 0.1 + 0.0001 * (i % 100), 0.2, 0.03);
+            portfolio.addStock(*stock, amount);
+            objects.push_back(stock);
+        } else {
+            auto bond = std::make_shared<BondInvestment>(0.04, 1 + static_cast<int>(i % 10), 0.02, i % 4 == 1);
+            portfolio.addBond(*bond, amount);
+            objects.push_back(bond);
+        }
+        amounts.push_back(amount);
+    }
+
+    h.measure("vector<shared_ptr<InvestmentStrategy>> book, per position", positions, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < positions; ++i) {
+            const InvestmentStrategy& s = *objects[i];
+            total += s.invest(amounts[i]) + s.calculatePotentialReturn(amounts[i]) + s.calculateRisk();
+        }
+        sink = total;
+    });
+    PortfolioValuation valuation;
+    h.measure("Portfolio::evaluate, per position", positions, [&] {
+        portfolio.evaluate(valuation);
+        sink = valuation.totalValue;
+    });
+}
+
+void benchBondGrowth(BenchmarkHarness& h) {
+    const std::size_t n = 1 << 20;
+    BondInvestment bond(0.05, 7, 0.02, true);
+    const InvestmentStrategy& strategy = bond;
+
+    h.measure("Bond invest uncached pow (reference)", n, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            double amount = 100.0 + static_cast<double>(i & 1023);
+            double effectiveRate = bond.getInterestRate();
+            if (bond.isCallable())
+                effectiveRate *= bond.getCallableAdjustment();
+            if (effectiveRate > bond.getInflationRate())
+                effectiveRate -= bond.getInflationRate() * bond.getInflationAdjustment();
+            total += amount * std::pow(1.0 + effectiveRate, bond.getTermYears());
+        }
+        sink = total;
+    });
+    h.measure("Bond invest cached growth", n, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            total += strategy.invest(100.0 + static_cast<double>(i & 1023));
+        sink = total;
+    });
+
+    const int maxYears = 30;
+    const std::size_t sweeps = 20000;
+    h.measure("Term sweep std::pow, per term", sweeps * maxYears, [&] {
+        double total = 0.0;
+        for (std::size_t s = 0; s < sweeps; ++s)
+            for (int year = 1; year <= maxYears; ++year)
+                total += std::pow(1.0 + bond.getEffectiveRate() + 1e-9 * s, year);
+        sink = total;
+    });
+    h.measure("Term sweep integerPower, per term", sweeps * maxYears, [&] {
+        double total = 0.0;
+        for (std::size_t s = 0; s < sweeps; ++s)
+            for (int year = 1; year <= maxYears; ++year)
+                total += BondInvestment::integerPower(1.0 + bond.getEffectiveRate() + 1e-9 * s, year);
+        sink = total;
+    });
+    h.measure("Term sweep growthTable, per term", sweeps * maxYears, [&] {
+        double total = 0.0;
+        for (std::size_t s = 0; s < sweeps; ++s) {
+            std::vector<double> table = bond.growthTable(maxYears);
+            for (int year = 1; year <= maxYears; ++year)
+                total += table[year - 1];
+        }
+        sink = total;
+    });
+}
+
+void benchScenarioGrid(BenchmarkHarness& h) {
+    std::vector<ParameterRange> ranges;
+    ranges.push_back(ParameterRange(0.01, 0.10, 40));
+    ranges.push_back(ParameterRange(1.0, 30.0, 30));
+    ranges.push_back(ParameterRange(0.0, 0.05, 26));
+    ranges.push_back(ParameterRange(0.0, 1.0, 2));
+    ScenarioGrid grid(ranges);
+
+    h.measureRepeated("Bond grid nested loops, per point", grid.size(), 3, [&] {
+        double total = 0.0;
+        for (std::size_t r = 0; r < 40; ++r)
+            for (int term = 1; term <= 30; ++term)
+                for (std::size_t f = 0; f < 26; ++f)
+                    for (int callable = 0; callable < 2; ++callable) {
+                        BondInvestment bond(ranges[0].at(r), term, ranges[2].at(f), callable == 1);
+                        total += bond.invest(1000.0) + bond.calculatePotentialReturn(1000.0) + bond.calculateRisk();
+                    }
+        sink = total;
+    });
+
+    std::size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        ThreadPool pool(threads);
+        ScenarioRunner runner(pool);
+        h.measureRepeated("Bond grid ScenarioRunner per point, " + std::to_string(threads) + " threads", grid.size(), 3, [&] {
+            double total = 0.0;
+            runner.runBonds(grid, BondInvestment(), 1000.0, [&](const ScenarioResult* results, std::size_t count) {
+                for (std::size_t i = 0; i < count; ++i)
+                    total += results[i].value;
+            });
+            sink = total;
+        });
+    }
+}
+
+void benchKernels(BenchmarkHarness& h) {
+    const std::size_t n = 1 << 20;
+    std::vector<double> amounts = makeAmounts(n);
+    std::vector<double> out(n);
+
+    StockInvestment stock(0.5, 0.15, 0.2, 0.03);
+    BondInvestment bond(0.06, 7, 0.025, true);
+    const InvestmentStrategy* virtualStock = &stock;
+    const InvestmentStrategy* virtualBond = &bond;
+    StockModel stockModel = StockModel::from(stock);
+    BondModel<AlwaysCallable> bondModel(0.06, 7, 0.025, true);
+
+    h.measure("Stock virtual invest loop", n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = virtualStock->invest(amounts[i]);
+        sink = out[n - 1];
+    });
+    h.measure("StockModel investBatch (static dispatch)", n, [&] {
+        stockModel.investBatch(amounts.data(), out.data(), n);
+        sink = out[n - 1];
+    });
+    h.measure("Bond virtual invest + calculateRisk loop", n, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            total += virtualBond->invest(amounts[i]) + virtualBond->calculateRisk();
+        sink = total;
+    });
+    h.measure("BondModel<AlwaysCallable> value + risk loop", n, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            total += bondModel.value(amounts[i]) + bondModel.risk();
+        sink = total;
+    });
+
+    Bank bank("Virtual", 1e15);
+    bank.setStrategy(std::make_shared<StockInvestment>(stock));
+    VariantBank variantBank("Variant", 1e15);
+    variantBank.setStrategy(stockModel);
+    h.measure("Bank executeInvestment (virtual)", n, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            total += bank.executeInvestment(amounts[i]);
+        sink = total;
+    });
+    h.measure("VariantBank executeInvestment", n, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i)
+            total += variantBank.executeInvestment(amounts[i]);
+        sink = total;
+    });
+}
+
+void benchPositionFile(BenchmarkHarness& h) {
+    const char* path = "bench_positions.bin";
+    const std::size_t positions = 2000000;
+    {
+        PositionFileWriter writer(path);
+        StockInvestment stock(0.5, 0.15, 0.2, 0.03);
+        BondInvestment bond(0.06, 7, 0.025, true);
+        for (std::size_t i = 0; i < positions; ++i) {
+            if (i % 2 == 0)
+                writer.add(stock, 1000.0 + static_cast<double>(i % 977));
+            else
+                writer.add(bond, 1000.0 + static_cast<double>(i % 977));
+        }
+    }
+
+    PositionFileReader reader(path);
+    h.measureRepeated("PositionFileReader evaluate, per record", positions, 3, [&] {
+        double total = 0.0;
+        reader.evaluate([&](std::size_t, const PositionValuation* results, std::size_t count) {
+            for (std::size_t i = 0; i < count; ++i)
+                total += results[i].value;
+        });
+        sink = total;
+    }, sizeof(PositionRecord));
+    std::remove(path);
+}
+
+void benchPeriodSimulation(BenchmarkHarness& h) {
+    const std::size_t positions = 100000;
+    const int months = 120;
+    StockInvestment stock(0.4, 0.07, 0.15, 0.02);
+    std::vector<BondInvestment> bonds;
+    for (int years = 1; years <= 10; ++years)
+        bonds.push_back(BondInvestment(0.03 + 0.002 * years, years, 0.02));
+
+    // Staggered purchases spread the anniversaries over the year
+    auto build = [&](Bank& bank, PeriodSimulation& simulation) {
+        for (std::size_t i = 0; i < positions; ++i) {
+            if (i % (positions / 12) == 0)
+                simulation.step();
+            if (i % 2 == 0)
+                simulation.addHolding(stock, 1000.0);
+            else
+                simulation.addBond(bonds[i % bonds.size()], 1000.0);
+        }
+        sink = bank.getAvailableFunds();
+    };
+
+    std::vector<ValuationSnapshot> snapshots;
+    h.measureRepeated("Monthly step + snapshot per position-month, calendar buckets", positions * months, 3, [&] {
+        Bank bank("Bench", positions * 1000.0);
+        PeriodSimulation simulation(bank, 12);
+        build(bank, simulation);
+        snapshots.clear();
+        simulation.advance(months, &snapshots);
+        sink = snapshots.back().totalValue;
+    });
+
+    // Baseline: revalue every position every month
+    std::vector<double> principal(positions, 1000.0), growth(positions), value(positions);
+    std::vector<int> opened(positions), maturity(positions);
+    for (std::size_t i = 0; i < positions; ++i) {
+        opened[i] = static_cast<int>(i / (positions / 12));
+        const BondInvestment& bond = bonds[i % bonds.size()];
+        growth[i] = i % 2 == 0 ? stock.invest(1000.0) / 1000.0 : 1.0 + bond.getEffectiveRate();
+        maturity[i] = i % 2 == 0 ? -1 : opened[i] + bond.getTermYears() * 12;
+    }
+    h.measureRepeated("Monthly step + snapshot per position-month, full revaluation", positions * months, 3, [&] {
+        double total = 0.0;
+        for (int month = 1; month <= months; ++month) {
+            total = 0.0;
+            for (std::size_t i = 0; i < positions; ++i) {
+                int age = month + 12 - opened[i];
+                if (maturity[i] >= 0 && month + 12 >= maturity[i])
+                    continue;
+                value[i] = principal[i] * std::pow(growth[i], age / 12);
+                total += value[i];
+            }
+        }
+        sink = total;
+    });
+}
+
+void benchRebalancingBank(BenchmarkHarness& h) {
+    std::vector<std::shared_ptr<InvestmentStrategy> > strategies;
+    for (int i = 0; i < 4096; ++i) {
+        if (i % 2 == 0)
+            strategies.push_back(std::make_shared<StockInvestment>(0.1 + 0.0001 * i, 0.05, 0.1, 0.01));
+        else
+            strategies.push_back(std::make_shared<BondInvestment>(0.03, 1 + i % 10, 0.02));
+    }
+
+    for (std::size_t legs = 8; legs <= strategies.size(); legs *= 8) {
+        RebalancingBank serial("Serial", 1e300, ThreadPool::shared(), legs + 1);
+        RebalancingBank parallel("Parallel", 1e300, ThreadPool::shared(), 1);
+        for (std::size_t i = 0; i < legs; ++i) {
+            serial.addLeg(strategies[i], 1.0 + i % 5);
+            parallel.addLeg(strategies[i], 1.0 + i % 5);
+        }
+        const std::size_t ops = 4096 * 8 / legs;
+        h.measure("executeInvestment " + std::to_string(legs) + " legs, serial", ops, [&] {
+            for (std::size_t i = 0; i < ops; ++i)
+                sink = serial.executeInvestment(1000.0);
+        });
+        h.measure("executeInvestment " + std::to_string(legs) + " legs, parallel", ops, [&] {
+            for (std::size_t i = 0; i < ops; ++i)
+                sink = parallel.executeInvestment(1000.0);
+        });
+    }
+
+    RebalancingBank bank("Weights", 0.0);
+    for (std::size_t i = 0; i < strategies.size(); ++i)
+        bank.addLeg(strategies[i], 1.0);
+    const std::size_t updates = 100000;
+    h.measure("setWeight, 4096 legs", updates, [&] {
+        for (std::size_t i = 0; i < updates; ++i)
+            bank.setWeight(i % 4096, 1.0 + i % 3);
+    });
+}
+
+void benchStrategyCache(BenchmarkHarness& h) {
+    // Many clients holding a few hundred distinct configurations
+    std::vector<std::shared_ptr<InvestmentStrategy> > book;
+    for (int i = 0; i < 100000; ++i) {
+        int config = (i * 7919) % 300;
+        if (config % 3 == 0)
+            book.push_back(std::make_shared<BondInvestment>(0.02 + 0.0001 * config, 1 + config % 10, 0.01, config % 2 == 0));
+        else if (config % 3 == 1)
+            book.push_back(std::make_shared<StockInvestment>(0.5, 0.05 + 0.0001 * config, 0.2, 0.02));
+        else
+            book.push_back(std::make_shared<CryptoInvestment>("Coin", 0.8, 0.5 + 0.01 * config));
+    }
+
+    h.measure("risk + potential return per position, direct", book.size(), [&] {
+        double total = 0.0;
+        for (const auto& strategy : book)
+            total += strategy->calculateRisk() + strategy->calculatePotentialReturn(1000.0);
+        sink = total;
+    });
+
+    StrategyCache cache;
+    h.measure("risk + potential return per position, cached", book.size(), [&] {
+        double total = 0.0;
+        for (const auto& strategy : book) {
+            CachedEvaluation cached = cache.evaluate(*strategy);
+            total += cached.risk + 1000.0 * cached.returnPerUnit;
+        }
+        sink = total;
+    });
+    sink = static_cast<double>(cache.hits()) / static_cast<double>(cache.hits() + cache.misses());
+
+    // The same book with a strategy whose risk takes a short simulation, where the cache pays off
+    struct SimulatedRiskStock : StockInvestment {
+        explicit SimulatedRiskStock(double returnRate) : StockInvestment(0.5, returnRate) {}
+        double calculateRisk() const override {
+            double total = 0.0;
+            for (int path = 1; path <= 64; ++path)
+                total += std::exp(-getVolatilityFactor() * path / 64.0);
+            return getRiskRating() * 1.5 + total / 64.0;
+        }
+    };
+    std::vector<std::shared_ptr<InvestmentStrategy> > simulated;
+    for (int i = 0; i < 100000; ++i)
+        simulated.push_back(std::make_shared<SimulatedRiskStock>(0.05 + 0.0001 * ((i * 7919) % 300)));
+    h.measure("simulated risk + potential return, direct", simulated.size(), [&] {
+        double total = 0.0;
+        for (const auto& strategy : simulated)
+            total += strategy->calculateRisk() + strategy->calculatePotentialReturn(1000.0);
+        sink = total;
+    });
+    h.measure("simulated risk + potential return, cached", simulated.size(), [&] {
+        double total = 0.0;
+        for (const auto& strategy : simulated) {
+            CachedEvaluation cached = cache.evaluate(*strategy);
+            total += cached.risk + 1000.0 * cached.returnPerUnit;
+        }
+        sink = total;
+    });
+}
+
+// Recording cost; rebuild with METRICS=1 to see the instrumented bank and strategies groups
+void benchMetrics(BenchmarkHarness& h) {
+    const std::size_t ops = 1000000;
+    h.measure("Metrics::count", ops, [&] {
+        for (std::size_t i = 0; i < ops; ++i)
+            Metrics::count(MetricBankInvestments);
+    });
+    h.measure("Metrics::record", ops, [&] {
+        for (std::size_t i = 0; i < ops; ++i)
+            Metrics::record(MetricBankExecuteLatency, i & 4095);
+    });
+    h.measure("MetricTimer scope", ops, [&] {
+        for (std::size_t i = 0; i < ops; ++i) {
+            MetricTimer timer(MetricStrategyInvestLatency);
+        }
+    });
+    h.measure("Metrics::snapshot + toJson", 1000, [&] {
+        for (int i = 0; i < 1000; ++i)
+            sink = static_cast<double>(Metrics::snapshot().toJson().size());
+    });
+}
+
+// One scenario run: build a book of strategies, value it, discard it
+void benchStrategyArena(BenchmarkHarness& h) {
+    const std::size_t n = 100000;
+    h.measureRepeated("create + destroy per strategy, make_shared", n, 3, [&] {
+        std::vector<std::shared_ptr<InvestmentStrategy> > book;
+        book.reserve(n);
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 2 == 0)
+                book.push_back(std::make_shared<StockInvestment>(0.5, 0.05 + 1e-7 * i));
+            else
+                book.push_back(std::make_shared<BondInvestment>(0.03 + 1e-7 * i, 5));
+            total += book.back()->invest(1000.0);
+        }
+        sink = total;
+    });
+
+    StrategyArena arena;
+    std::vector<const InvestmentStrategy*> book;
+    book.reserve(n);
+    h.measureRepeated("create + destroy per strategy, arena", n, 3, [&] {
+        book.clear();
+        double total = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (i % 2 == 0)
+                book.push_back(arena.create<StockInvestment>(0.5, 0.05 + 1e-7 * i));
+            else
+                book.push_back(arena.create<BondInvestment>(0.03 + 1e-7 * i, 5));
+            total += book.back()->invest(1000.0);
+        }
+        sink = total;
+        arena.reset();
+    });
+
+    const std::size_t ops = 1 << 20;
+    Bank owning("Owning", 1e15);
+    owning.setStrategy(std::make_shared<BondInvestment>());
+    h.measure("Bank executeInvestment, shared_ptr strategy", ops, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < ops; ++i)
+            total += owning.executeInvestment(1000.0);
+        sink = total;
+    });
+    Bank borrowing("Borrowing", 1e15);
+    borrowing.setBorrowedStrategy(arena.create<BondInvestment>());
+    h.measure("Bank executeInvestment, borrowed arena strategy", ops, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < ops; ++i)
+            total += borrowing.executeInvestment(1000.0);
+        sink = total;
+    });
+}
+
+// Deposits against a local journal file: one sync per N records, then N concurrent waiters
+// sharing syncs through group commit, then recovery
+void benchJournal(BenchmarkHarness& h) {
+    const char* journalPath = "bench_bank.journal";
+    const char* snapshotPath = "bench_bank.snapshot";
+    std::remove(journalPath);
+    std::remove(snapshotPath);
+
+    const std::size_t batches[] = {1, 8, 64, 512};
+    for (std::size_t batch : batches) {
+        JournaledBank bank(journalPath, snapshotPath, "Journal", 0.0, JournalOptions(false, batch));
+        const std::size_t ops = batch < 64 ? 512 : 8192;
+        h.measureRate("deposit, commit every " + std::to_string(batch), ops, 3, [&] {
+            for (std::size_t i = 0; i < ops; ++i)
+                bank.depositFunds(1.0);
+            bank.sync();
+        });
+        bank.checkpoint();
+    }
+
+    const int threadCounts[] = {1, 4, 16};
+    for (int threads : threadCounts) {
+        JournaledBank bank(journalPath, snapshotPath, "Journal");
+        const std::size_t perThread = 2048 / threads;
+        h.measureRate("deposit, wait for durability, " + std::to_string(threads) + " threads",
+                      perThread * threads, 3, [&] {
+            std::vector<std::thread> workers;
+            for (int t = 0; t < threads; ++t) {
+                workers.push_back(std::thread([&] {
+                    for (std::size_t i = 0; i < perThread; ++i)
+                        bank.depositFunds(1.0);
+                }));
+            }
+            for (auto& worker : workers)
+                worker.join();
+        });
+        bank.checkpoint();
+    }
+
+    {
+        JournaledBank bank(journalPath, snapshotPath, "Journal", 0.0, JournalOptions(false, 4096));
+        for (int i = 0; i < 1000000; ++i)
+            bank.depositFunds(1.0);
+    }
+    h.measureRepeated("recover, per journal record", 1000000, 3, [&] {
+        JournaledBank bank(journalPath, snapshotPath, "Journal", 0.0, JournalOptions(false, 4096));
+        sink = bank.getAvailableFunds();
+    });
+    std::remove(journalPath);
+    std::remove(snapshotPath);
+}
+
+void benchPipeline(BenchmarkHarness& h) {
+    std::vector<std::shared_ptr<InvestmentStrategy> > strategies = sampleStrategies();
+    std::vector<std::unique_ptr<Bank> > banks;
+    for (int i = 0; i < 1024; ++i) {
+        banks.push_back(std::unique_ptr<Bank>(new Bank("Pipeline", 1e12)));
+        banks.back()->setStrategy(strategies[i % strategies.size()]);
+    }
+    std::vector<double> amounts = makeAmounts(banks.size());
+    const std::size_t requests = 65536;
+
+    h.measure("executeInvestment, synchronous", requests, [&] {
+        double total = 0.0;
+        for (std::size_t i = 0; i < requests; ++i)
+            total += banks[i & 1023]->executeInvestment(amounts[i & 1023]);
+        sink = total;
+    });
+
+    const std::size_t batchSizes[] = {1, 16, 256};
+    for (std::size_t batch : batchSizes) {
+        InvestmentPipeline pipeline(PipelineOptions(4096, batch, std::chrono::microseconds(50)));
+        double total = 0.0;
+        h.measureRepeated("pipeline callbacks, batch " + std::to_string(batch), requests, 3, [&] {
+            for (std::size_t i = 0; i < requests; ++i)
+                pipeline.submit(*banks[i & 1023], amounts[i & 1023], [&total](const InvestmentResult& result) {
+                    total += result.value;
+                });
+            pipeline.flush();
+        });
+        sink = total;
+    }
+
+    InvestmentPipeline pipeline;
+    h.measureRepeated("pipeline futures, batch 256", requests, 3, [&] {
+        std::vector<std::future<InvestmentResult> > results;
+        results.reserve(requests);
+        for (std::size_t i = 0; i < requests; ++i)
+            results.push_back(pipeline.submit(*banks[i & 1023], amounts[i & 1023]));
+        double total = 0.0;
+        for (std::future<InvestmentResult>& result : results)
+            total += result.get().value;
+        sink = total;
+    });
+}
+
+void benchRiskAggregator(BenchmarkHarness& h) {
+    const std::size_t positions = 500000;
+    RiskBook book(32);
+    book.reserve(positions);
+    for (std::size_t i = 0; i < positions; ++i)
+        book.addRisk(0.05 + static_cast<double>(i % 97) * 0.003, 10.0 + static_cast<double>((i * 7919) % 1000), i % 32);
+    for (std::size_t a = 0; a < 32; ++a)
+        for (std::size_t b = a + 1; b < 32; ++b)
+            book.setCorrelation(a, b, 0.25);
+
+    h.measure("sequential per-bucket pass", positions, [&] {
+        std::vector<double> riskSums(32, 0.0);
+        const double* exposure = book.exposures().data();
+        const double* risk = book.risks().data();
+        const std::uint32_t* bucket = book.buckets().data();
+        for (std::size_t i = 0; i < positions; ++i)
+            riskSums[bucket[i]] += exposure[i] * risk[i];
+        sink = riskSums[0];
+    });
+    ThreadPool single(1);
+    RiskSummary summary;
+    const std::size_t blockSizes[] = {1024, 16384};
+    for (std::size_t blockSize : blockSizes) {
+        RiskAggregator aggregator(single, blockSize);
+        h.measure("aggregate, 1 thread, block " + std::to_string(blockSize), positions, [&] {
+            aggregator.aggregate(book, summary);
+            sink = summary.volatility;
+        });
+    }
+    RiskAggregator shared(ThreadPool::shared(), 16384);
+    h.measure("aggregate, shared pool, block 16384", positions, [&] {
+        shared.aggregate(book, summary);
+        sink = summary.volatility;
+    });
+}
+
+void benchBankCluster(BenchmarkHarness& h) {
+    std::vector<std::shared_ptr<InvestmentStrategy> > strategies = sampleStrategies();
+    const std::size_t banks = 16384;
+    const std::size_t hardware = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::size_t> shardCounts;
+    for (std::size_t shards = 1; shards <= std::max<std::size_t>(4, hardware); shards *= 2)
+        shardCounts.push_back(shards);
+    for (std::size_t shards : shardCounts) {
+        BankCluster cluster(shards);
+        for (std::size_t i = 0; i < banks; ++i)
+            cluster.addBank(strategies[i % strategies.size()]->getStrategyName(), 1e12);
+        for (auto& strategy : strategies) {
+            const std::string name = strategy->getStrategyName();
+            cluster.setStrategyWhere(strategy, [&name](const Bank& bank) { return bank.getName() == name; });
+        }
+        const std::string suffix = ", " + std::to_string(shards) + " shards";
+        h.measure("investWhere all" + suffix, banks, [&] {
+            sizeSink = cluster.investWhere(100.0, [](const Bank&) { return true; });
+        });
+        const std::size_t transfers = 65536;
+        h.measureRate("transfer messages" + suffix, transfers, 3, [&] {
+            for (std::size_t i = 0; i < transfers; ++i)
+                cluster.transfer(i % banks, (i * 7919 + 1) % banks, 1.0);
+            cluster.quiesce();
+        });
+    }
+
+    // After the clusters, so shared_ptr reference counts use atomics here too, as in any
+    // process that has started a thread
+    std::vector<std::unique_ptr<Bank> > local;
+    for (std::size_t i = 0; i < banks; ++i) {
+        local.push_back(std::unique_ptr<Bank>(new Bank("Client", 1e12)));
+        local.back()->setStrategy(strategies[i % strategies.size()]);
+    }
+    h.measure("invest all, single-threaded loop", banks, [&] {
+        double total = 0.0;
+        for (auto& bank : local)
+            total += bank->tryExecuteInvestment(100.0).value;
+        sink = total;
+    });
+}
+
+void benchSensitivity(BenchmarkHarness& h) {
+    const std::size_t positions = 4096;
+    std::vector<StockInvestment> stocks;
+    std::vector<BondInvestment> bonds;
+    for (std::size_t i = 0; i < positions; ++i) {
+        stocks.push_back(StockInvestment(0.3 + 0.0001 * i, 0.1, 0.2, 0.03));
+        bonds.push_back(BondInvestment(0.04 + 0.00001 * i, 1 + static_cast<int>(i % 30), 0.02, i % 2 == 0));
+    }
+
+    // Bump-and-revalue through the setters: 2N+1 invest calls per position
+    h.measure("stock, bumped finite differences", positions, [&] {
+        double total = 0.0;
+        for (StockInvestment& stock : stocks) {
+            const double base = stock.invest(1000.0);
+            const double expected = stock.getExpectedReturn();
+            const double volatility = stock.getVolatilityFactor();
+            const double yield = stock.getDividendYield();
+            const double risk = stock.getRiskRating();
+            total += base + (stock.invest(1000.01) - stock.invest(999.99)) / 0.02;
+            stock.setRiskRating(risk + 1e-6);
+            double up = stock.invest(1000.0);
+            stock.setRiskRating(risk - 1e-6);
+            total += (up - stock.invest(1000.0)) / 2e-6;
+            stock.setRiskRating(risk);
+            stock.setExpectedReturn(expected + 1e-6);
+            up = stock.invest(1000.0);
+            stock.setExpectedReturn(expected - 1e-6);
+            total += (up - stock.invest(1000.0)) / 2e-6;
+            stock.setExpectedReturn(expected);
+            stock.setVolatilityFactor(volatility + 1e-6);
+            up = stock.invest(1000.0);
+            stock.setVolatilityFactor(volatility - 1e-6);
+            total += (up - stock.invest(1000.0)) / 2e-6;
+            stock.setVolatilityFactor(volatility);
+            stock.setDividendYield(yield + 1e-6);
+            up = stock.invest(1000.0);
+            stock.setDividendYield(yield - 1e-6);
+            total += (up - stock.invest(1000.0)) / 2e-6;
+            stock.setDividendYield(yield);
+        }
+        sink = total;
+    });
+    h.measure("stock, forward-mode AD", positions, [&] {
+        double total = 0.0;
+        for (const StockInvestment& stock : stocks) {
+            StockSensitivities s = investSensitivities(stock, 1000.0);
+            total += s.value + s.amount + s.riskRating + s.expectedReturn + s.volatilityFactor + s.dividendYield;
+        }
+        sink = total;
+    });
+
+    h.measure("bond, bumped finite differences", positions, [&] {
+        double total = 0.0;
+        for (BondInvestment& bond : bonds) {
+            const double base = bond.invest(1000.0);
+            const double rate = bond.getInterestRate();
+            const int years = bond.getTermYears();
+            const double inflation = bond.getInflationRate();
+            const double callableAdj = bond.getCallableAdjustment();
+            const double inflationAdj = bond.getInflationAdjustment();
+            total += base + (bond.invest(1000.01) - bond.invest(999.99)) / 0.02;
+            bond.setInterestRate(rate + 1e-6);
+            double up = bond.invest(1000.0);
+            bond.setInterestRate(rate - 1e-6);
+            total += (up - bond.invest(1000.0)) / 2e-6;
+            bond.setInterestRate(rate);
+            bond.setTermYears(years + 1);
+            up = bond.invest(1000.0);
+            bond.setTermYears(years > 1 ? years - 1 : years);
+            total += (up - bond.invest(1000.0)) / 2.0;
+            bond.setTermYears(years);
+            bond.setInflationRate(inflation + 1e-6);
+            up = bond.invest(1000.0);
+            bond.setInflationRate(inflation - 1e-6);
+            total += (up - bond.invest(1000.0)) / 2e-6;
+            bond.setInflationRate(inflation);
+            bond.setCallableAdjustment(callableAdj - 1e-6);
+            up = bond.invest(1000.0);
+            bond.setCallableAdjustment(callableAdj - 2e-6);
+            total += (up - bond.invest(1000.0)) / 1e-6;
+            bond.setCallableAdjustment(callableAdj);
+            bond.setInflationAdjustment(inflationAdj + 1e-6);
+            up = bond.invest(1000.0);
+            bond.setInflationAdjustment(inflationAdj - 1e-6);
+            total += (up - bond.invest(1000.0)) / 2e-6;
+            bond.setInflationAdjustment(inflationAdj);
+        }
+        sink = total;
+    });
+    h.measure("bond, forward-mode AD", positions, [&] {
+        double total = 0.0;
+        for (const BondInvestment& bond : bonds) {
+            BondSensitivities b = investSensitivities(bond, 1000.0);
+            total += b.value + b.amount + b.interestRate + b.termYears + b.inflationRate + b.callableAdjustment +
+                     b.inflationAdjustment;
+        }
+        sink = total;
+    });
+}
+
+void benchBankSnapshot(BenchmarkHarness& h) {
+    const char* path = "bench_banks.snapshot";
+    const std::size_t count = 1000000;
+    std::vector<std::shared_ptr<InvestmentStrategy> > shared = sampleStrategies();
+
+    // Half the banks share three strategies, half own a strategy with its own parameters
+    std::vector<Bank> banks;
+    banks.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::shared_ptr<InvestmentStrategy> strategy;
+        if (i % 2 == 0)
+            strategy = shared[(i / 2) % shared.size()];
+        else if (i % 4 == 1)
+            strategy = std::make_shared<StockInvestment>(0.5, 0.1 + 1e-9 * i, 0.2, 0.03);
+        else
+            strategy = std::make_shared<BondInvestment>(0.04 + 1e-9 * i, 1 + static_cast<int>(i % 30), 0.02, i % 8 == 3);
+        banks.emplace_back("Client " + std::to_string(i), 1000.0 + static_cast<double>(i % 977), strategy);
+    }
+
+    h.measureRepeated("rebuild 1M banks in code", count, 3, [&] {
+        std::vector<Bank> rebuilt;
+        rebuilt.reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            rebuilt.emplace_back("Client " + std::to_string(i), 1000.0 + static_cast<double>(i % 977));
+            if (i % 2 == 0)
+                rebuilt.back().setStrategy(shared[(i / 2) % shared.size()]);
+            else if (i % 4 == 1)
+                rebuilt.back().setStrategy(std::make_shared<StockInvestment>(0.5, 0.1 + 1e-9 * i, 0.2, 0.03));
+            else
+                rebuilt.back().setStrategy(std::make_shared<BondInvestment>(0.04 + 1e-9 * i, 1 + static_cast<int>(i % 30),
+                                                                            0.02, i % 8 == 3));
+        }
+        sizeSink = rebuilt.size();
+    });
+    h.measureRepeated("save 1M banks", count, 3, [&] {
+        saveBankSnapshot(path, banks);
+    });
+    h.measureRepeated("load 1M banks", count, 3, [&] {
+        std::vector<Bank> loaded = loadBankSnapshot(path);
+        sizeSink = loaded.size();
+    });
+    std::remove(path);
+}
+
+void benchBankBatch(BenchmarkHarness& h) {
+    const std::size_t bankCount = 10000;
+    const std::size_t count = 1000000;
+    std::vector<std::shared_ptr<InvestmentStrategy> > strategies = sampleStrategies();
+    // Balances are large enough that most operations keep succeeding across runs; about 1% of the
+    // amounts are non-positive and get rejected
+    std::vector<Bank> initial;
+    initial.reserve(bankCount);
+    for (std::size_t i = 0; i < bankCount; ++i)
+        initial.emplace_back("Client " + std::to_string(i), 1e7, strategies[i % strategies.size()]);
+    std::vector<BankOperation> operations(count);
+    std::vector<InvestmentStatus> statuses(count);
+    std::vector<double> values(count);
+
+    // Start a thread first, so shared_ptr reference counts use atomics as in any threaded program
+    std::thread([] {}).join();
+    auto measureMix = [&](const std::string& mix, unsigned depositTenths, unsigned withdrawalTenths) {
+        std::uint64_t state = 88172645463325252ULL;
+        for (std::size_t i = 0; i < count; ++i) {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            BankOperation& operation = operations[i];
+            operation.bank = static_cast<std::uint32_t>(state % bankCount);
+            const unsigned kind = static_cast<unsigned>((state >> 20) % 10);
+            operation.type = kind < depositTenths ? OperationDeposit
+                           : kind < depositTenths + withdrawalTenths ? OperationWithdrawal : OperationInvestment;
+            operation.amount = static_cast<double>((state >> 32) % 900) - 10.0;
+        }
+
+        std::vector<Bank> banks(initial);
+        h.measureRepeated("try* per call, 1M ops, " + mix, count, 5, [&] {
+            std::size_t ok = 0;
+            double total = 0.0;
+            for (std::size_t i = 0; i < count; ++i) {
+                const BankOperation& operation = operations[i];
+                Bank& bank = banks[operation.bank];
+                if (operation.type == OperationDeposit) {
+                    ok += bank.tryDepositFunds(operation.amount) == StatusOk;
+                } else if (operation.type == OperationWithdrawal) {
+                    ok += bank.tryWithdrawFunds(operation.amount) == StatusOk;
+                } else {
+                    InvestmentResult result = bank.tryExecuteInvestment(operation.amount);
+                    ok += result.ok();
+                    total += result.value;
+                }
+            }
+            sizeSink = ok;
+            sink = total;
+        });
+        banks = initial;
+        h.measureRepeated("applyOperations, 1M ops, " + mix, count, 5, [&] {
+            sizeSink = Bank::applyOperations(banks.data(), banks.size(), operations.data(), count, statuses.data(),
+                                             values.data());
+            sink = values[count - 1];
+        });
+    };
+    measureMix("funds only", 5, 5);
+    measureMix("mixed", 5, 2);
+    measureMix("investments only", 0, 0);
+}
+void benchYieldCurve(BenchmarkHarness& h) {
+    const std::size_t count = 10000;
+    const std::vector<double> maturities = {1.0, 2.0, 5.0, 10.0, 30.0};
+    const std::vector<double> low = {0.020, 0.024, 0.030, 0.035, 0.040};
+    const std::vector<double> high = {0.021, 0.025, 0.031, 0.036, 0.041};
+    std::shared_ptr<YieldCurve> curve = std::make_shared<YieldCurve>(maturities, low, 30);
+    std::vector<BondInvestment> bonds;
+    std::vector<BondInvestment> flatBonds;
+    bonds.reserve(count);
+    flatBonds.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const int years = 1 + static_cast<int>(i % 30);
+        flatBonds.emplace_back(curve->gridZeroRate(years), years, 0.02, i % 4 == 0);
+        bonds.emplace_back(flatBonds.back());
+        bonds.back().setYieldCurve(curve);
+    }
+
+    // The flat baseline recomputes each bond's growth factor, as each bond would without a curve
+    bool shift = false;
+    h.measureRepeated("flat bonds, set each rate", count, 50, [&] {
+        const std::vector<double>& rates = shift ? high : low;
+        shift = !shift;
+        for (BondInvestment& bond : flatBonds) {
+            const int years = bond.getTermYears();
+            bond.setInterestRate(years >= 10 ? rates[3] + (rates[4] - rates[3]) * (years - 10) / 20.0 : rates[0]);
+        }
+        sink = flatBonds[count - 1].getGrowthFactor();
+    });
+    h.measureRepeated("curve bonds, update curve", count, 50, [&] {
+        curve->setZeroRates(maturities, shift ? high : low);
+        shift = !shift;
+        sink = bonds[count - 1].getGrowthFactor();
+    });
+    h.measure("curve bonds, invest", count, [&] {
+        double total = 0.0;
+        for (const BondInvestment& bond : bonds)
+            total += bond.invest(1000.0);
+        sink = total;
+    });
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    BenchmarkHarness harness(argc, argv);
+    harness.add("strategies", benchStrategies);
+    harness.add("invest_batch", benchInvestBatch);
+    harness.add("bank", benchBank);
+    harness.add("rejections", benchRejections);
+    harness.add("details", benchDetails);
+    harness.add("monte_carlo", benchMonteCarlo);
+    harness.add("crypto", benchCrypto);
+    harness.add("portfolio", benchPortfolio);
+    harness.add("bond_growth", benchBondGrowth);
+    harness.add("scenario_grid", benchScenarioGrid);
+    harness.add("kernels", benchKernels);
+    harness.add("position_file", benchPositionFile);
+    harness.add("period_simulation", benchPeriodSimulation);
+    harness.add("rebalancing_bank", benchRebalancingBank);
+    harness.add("strategy_cache", benchStrategyCache);
+    harness.add("strategy_arena", benchStrategyArena);
+    harness.add("journal", benchJournal);
+    harness.add("pipeline", benchPipeline);
+    harness.add("risk_aggregator", benchRiskAggregator);
+    harness.add("bank_cluster", benchBankCluster);
+    harness.add("sensitivity", benchSensitivity);
+    harness.add("bank_snapshot", benchBankSnapshot);
+    harness.add("bank_batch", benchBankBatch);
+    harness.add("yield_curve", benchYieldCurve);
+    harness.add("metrics", benchMetrics);
+    return harness.run();
+}
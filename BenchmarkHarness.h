@@ -0,0 +1,163 @@
+#ifndef BENCHMARK_HARNESS_H
+#define BENCHMARK_HARNESS_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "AllocationCounter.h"
+
+#define BENCH_STRINGIFY_IMPL(x) #x
+#define BENCH_STRINGIFY(x) BENCH_STRINGIFY_IMPL(x)
+#ifndef BENCH_BUILD
+#define BENCH_BUILD unspecified
+#endif
+
+struct BenchmarkResult {
+    std::string group;
+    std::string name;
+    std::size_t operations;     // operations per timed run
+    double nsPerOp;             // best of the timed runs
+    double allocationsPerOp;    // averaged over all timed runs
+    double bytesPerOp;          // input bytes per operation, 0 when throughput is not meaningful
+    bool reportRate;            // also report operations per second
+};
+
+// Minimal benchmark driver used by Benchmark.cpp.
+// Options: --json (machine-readable output), --filter=<text> (groups containing text), --repeats=<n>
+class BenchmarkHarness {
+public:
+    typedef void (*Group)(BenchmarkHarness&);
+
+    BenchmarkHarness(int argc, char* argv[]) : json(false), repeats(5) {
+        for (int i = 1; i < argc; ++i) {
+            if (std::strcmp(argv[i], "--json") == 0)
+                json = true;
+            else if (std::strncmp(argv[i], "--filter=", 9) == 0)
+                filter = argv[i] + 9;
+            else if (std::strncmp(argv[i], "--repeats=", 10) == 0)
+                repeats = std::max(1, std::atoi(argv[i] + 10));
+        }
+    }
+
+    void add(const std::string& name, Group group) {
+        groups.push_back(std::make_pair(name, group));
+    }
+
+    int run() {
+        for (const auto& group : groups) {
+            if (!filter.empty() && group.first.find(filter) == std::string::npos)
+                continue;
+            currentGroup = group.first;
+            if (!json)
+                std::cout << "[" << currentGroup << "]\n";
+            group.second(*this);
+        }
+        if (json)
+            printJson(std::cout);
+        return 0;
+    }
+
+    // Runs fn once to warm up, then `repeats` timed runs of opsPerRun operations each
+    template <typename Fn>
+    void measure(const std::string& name, std::size_t opsPerRun, Fn fn, double bytesPerOp = 0.0) {
+        measureRepeated(name, opsPerRun, repeats, fn, bytesPerOp);
+    }
+
+    // As measure(), for cases too slow to repeat the default number of times
+    template <typename Fn>
+    void measureRepeated(const std::string& name, std::size_t opsPerRun, int runs, Fn fn, double bytesPerOp = 0.0) {
+        timeRuns(name, opsPerRun, runs, fn, bytesPerOp, false);
+    }
+
+    // As measureRepeated(), also reporting operations per second (for I/O-bound cases)
+    template <typename Fn>
+    void measureRate(const std::string& name, std::size_t opsPerRun, int runs, Fn fn) {
+        timeRuns(name, opsPerRun, runs, fn, 0.0, true);
+    }
+
+private:
+    template <typename Fn>
+    void timeRuns(const std::string& name, std::size_t opsPerRun, int runs, Fn fn, double bytesPerOp, bool reportRate) {
+        fn();
+        double best = 0.0;
+        unsigned long long allocationsBefore = allocationCount();
+        for (int r = 0; r < runs; ++r) {
+            auto start = std::chrono::steady_clock::now();
+            fn();
+            auto stop = std::chrono::steady_clock::now();
+            double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+            if (r == 0 || ns < best)
+                best = ns;
+        }
+        double totalOps = static_cast<double>(opsPerRun) * runs;
+
+        BenchmarkResult result;
+        result.group = currentGroup;
+        result.name = name;
+        result.operations = opsPerRun;
+        result.nsPerOp = best / static_cast<double>(opsPerRun);
+        result.allocationsPerOp = static_cast<double>(allocationCount() - allocationsBefore) / totalOps;
+        result.bytesPerOp = bytesPerOp;
+        result.reportRate = reportRate;
+        results.push_back(result);
+        if (!json)
+            printText(std::cout, result);
+    }
+
+    static void printText(std::ostream& out, const BenchmarkResult& result) {
+        out << "  " << result.name << ": " << result.nsPerOp << " ns/op, "
+            << result.allocationsPerOp << " allocs/op";
+        if (result.bytesPerOp > 0.0)
+            out << ", " << result.bytesPerOp / result.nsPerOp << " GB/s";
+        if (result.reportRate)
+            out << ", " << 1e9 / result.nsPerOp << " ops/s";
+        out << "\n";
+    }
+
+    static std::string quoted(const std::string& text) {
+        std::string out = "\"";
+        for (char c : text) {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    void printJson(std::ostream& out) const {
+        out << "{\n"
+            << "  \"build\": " << quoted(BENCH_STRINGIFY(BENCH_BUILD)) << ",\n"
+            << "  \"compiler\": " << quoted(__VERSION__) << ",\n"
+            << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+            << "  \"results\": [";
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const BenchmarkResult& r = results[i];
+            out << (i == 0 ? "\n" : ",\n")
+                << "    {\"group\": " << quoted(r.group) << ", \"name\": " << quoted(r.name)
+                << ", \"operations\": " << r.operations << ", \"ns_per_op\": " << r.nsPerOp
+                << ", \"allocations_per_op\": " << r.allocationsPerOp;
+            if (r.bytesPerOp > 0.0)
+                out << ", \"gb_per_s\": " << r.bytesPerOp / r.nsPerOp;
+            if (r.reportRate)
+                out << ", \"ops_per_s\": " << 1e9 / r.nsPerOp;
+            out << "}";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    bool json;
+    int repeats;
+    std::string filter;
+    std::string currentGroup;
+    std::vector<std::pair<std::string, Group> > groups;
+    std::vector<BenchmarkResult> results;
+};
+
+#endif // BENCHMARK_HARNESS_H
@@ -1,6 +1,11 @@
 #include "InvestmentSimulator.h"
+#include "DetailFormat.h"
+#include "Metrics.h"
+#include "StrategyFormulas.h"
+#include "YieldCurve.h"
 #include <cmath>
-#include <sstream>
+#include <typeinfo>
+#include <vector>
 
 BondInvestment::BondInvestment(double rate, int years, double inflation, bool isCallable,
                                double callableAdj, double riskWeight, double inflationAdj)
@@ -20,49 +25,151 @@ BondInvestment::BondInvestment(double rate, int years, double inflation, bool is
         throw InvestmentException("Base risk weight cannot be negative");
     if (inflationAdj <= 0.0)
         throw InvestmentException("Inflation adjustment must be positive");
+    updateCachedRates();
 }
 
-double BondInvestment::invest(double amount) const {
-    if (amount <= 0)
-        throw InvestmentException("Investment amount must be positive");
+BondInvestment::BondInvestment(const BondInvestment& other)
+    : InvestmentStrategy(other), interestRate(other.interestRate), termYears(other.termYears),
+      inflationRate(other.inflationRate), callable(other.callable),
+      callableAdjustment(other.callableAdjustment), baseRiskWeight(other.baseRiskWeight),
+      inflationAdjustment(other.inflationAdjustment), cachedEffectiveRate(other.cachedEffectiveRate),
+      cachedGrowthFactor(other.cachedGrowthFactor), termsFingerprint(other.termsFingerprint),
+      yieldCurve(other.yieldCurve)
+{
+    if (yieldCurve)
+        yieldCurve->attach(*this);
+}
+
+BondInvestment& BondInvestment::operator=(const BondInvestment& other) {
+    if (this != &other) {
+        if (yieldCurve)
+            yieldCurve->detach(*this);
+        InvestmentStrategy::operator=(other);
+        interestRate = other.interestRate;
+        termYears = other.termYears;
+        inflationRate = other.inflationRate;
+        callable = other.callable;
+        callableAdjustment = other.callableAdjustment;
+        baseRiskWeight = other.baseRiskWeight;
+        inflationAdjustment = other.inflationAdjustment;
+        cachedEffectiveRate = other.cachedEffectiveRate;
+        cachedGrowthFactor = other.cachedGrowthFactor;
+        termsFingerprint = other.termsFingerprint;
+        yieldCurve = other.yieldCurve;
+        if (yieldCurve)
+            yieldCurve->attach(*this);
+    }
+    return *this;
+}
 
-    double effectiveRate = interestRate;
-    if (callable)
-        effectiveRate *= callableAdjustment;
+BondInvestment::~BondInvestment() {
+    if (yieldCurve)
+        yieldCurve->detach(*this);
+}
 
-    if (effectiveRate > inflationRate)
-        effectiveRate -= inflationRate * inflationAdjustment;
+// Recomputed only when a setter changes an input, so pricing calls are a single multiply.
+// Refreshes the parameter fingerprint along with the rates.
+void BondInvestment::updateCachedRates() {
+    if (yieldCurve) {
+        yieldCurve->price(*this);
+        return;
+    }
+    cachedEffectiveRate = bondEffectiveRate(interestRate, inflationRate, callable, callableAdjustment, inflationAdjustment);
+    cachedGrowthFactor = bondGrowthFactor(cachedEffectiveRate, static_cast<double>(termYears));
+    updateFingerprint();
+}
 
-    return amount * std::pow(1.0 + effectiveRate, termYears);
+double BondInvestment::integerPower(double base, int exponent) {
+    if (exponent < 0)
+        return 1.0 / integerPower(base, -exponent);
+    double result = 1.0;
+    while (exponent > 0) {
+        if (exponent & 1)
+            result *= base;
+        base *= base;
+        exponent >>= 1;
+    }
+    return result;
 }
 
-double BondInvestment::calculatePotentialReturn(double amount) const {
-    if (amount <= 0)
-        throw InvestmentException("Investment amount must be positive");
+std::vector<double> BondInvestment::growthTable(int maxYears) const {
+    if (maxYears <= 0)
+        throw InvestmentException("Term years must be positive");
+    std::vector<double> table(maxYears);
+    const double step = 1.0 + cachedEffectiveRate;
+    double growth = 1.0;
+    for (int year = 0; year < maxYears; ++year) {
+        growth *= step;
+        table[year] = growth;
+    }
+    return table;
+}
+
+double BondInvestment::getEffectiveRate() const {
+    return cachedEffectiveRate;
+}
 
-    double effectiveRate = interestRate;
-    if (callable)
-        effectiveRate *= callableAdjustment;
+double BondInvestment::getGrowthFactor() const {
+    return cachedGrowthFactor;
+}
 
-    if (effectiveRate > inflationRate)
-        effectiveRate -= inflationRate * inflationAdjustment;
+InvestmentResult BondInvestment::tryInvest(double amount) const {
+    INVESTMENT_METRIC_COUNT(MetricStrategyInvestments);
+    INVESTMENT_METRIC_TIME(MetricStrategyInvestLatency);
+    if (amount <= 0) {
+        INVESTMENT_METRIC_COUNT(MetricInvalidAmount);
+        return InvestmentResult::failure(StatusInvalidAmount);
+    }
+    return InvestmentResult::success(amount * cachedGrowthFactor);
+}
 
-    return amount * effectiveRate * termYears;
+InvestmentResult BondInvestment::tryCalculatePotentialReturn(double amount) const {
+    if (amount <= 0)
+        return InvestmentResult::failure(StatusInvalidAmount);
+    return InvestmentResult::success(amount * cachedEffectiveRate * termYears);
 }
 
 double BondInvestment::calculateRisk() const {
     return baseRiskWeight * riskRating + (callable ? 0.1 : 0.0) + inflationRate * inflationAdjustment;
 }
 
+void BondInvestment::investBatch(const double* amounts, double* out, std::size_t n) const {
+    if (typeid(*this) != typeid(BondInvestment)) {
+        InvestmentStrategy::investBatch(amounts, out, n);   // a subclass may override invest()
+        return;
+    }
+    validateBatch(amounts, out, n);
+    const double growth = cachedGrowthFactor;
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = amounts[i] * growth;
+}
+
+// The interest rate is mixed in last, so a yield curve update can refresh the fingerprint from
+// termsFingerprint with a single mix
+ParameterFingerprint BondInvestment::computeFingerprint() const {
+    ParameterFingerprint hash = InvestmentStrategy::computeFingerprint();
+    hash = mixFingerprint(hash, termYears);
+    hash = mixFingerprint(hash, inflationRate);
+    hash = mixFingerprint(hash, callable ? 1.0 : 0.0);
+    hash = mixFingerprint(hash, callableAdjustment);
+    hash = mixFingerprint(hash, baseRiskWeight);
+    hash = mixFingerprint(hash, inflationAdjustment);
+    termsFingerprint = hash;
+    return mixFingerprint(hash, interestRate);
+}
+
 double BondInvestment::getInterestRate() const {
     return interestRate;
 }
 
 void BondInvestment::setInterestRate(double rate) {
+    if (yieldCurve)
+        throw InvestmentException("Interest rate is set by the yield curve");
     if (rate >= 0.0)
         interestRate = rate;
     else
         throw InvestmentException("Interest rate cannot be negative");
+    updateCachedRates();
 }
 
 int BondInvestment::getTermYears() const {
@@ -70,10 +177,13 @@ int BondInvestment::getTermYears() const {
 }
 
 void BondInvestment::setTermYears(int years) {
+    if (yieldCurve && years > yieldCurve->getHorizonYears())
+        throw InvestmentException("Term years are beyond the curve horizon");
     if (years > 0)
         termYears = years;
     else
         throw InvestmentException("Term years must be positive");
+    updateCachedRates();
 }
 
 double BondInvestment::getInflationRate() const {
@@ -85,6 +195,7 @@ void BondInvestment::setInflationRate(double inflation) {
         inflationRate = inflation;
     else
         throw InvestmentException("Inflation rate cannot be negative");
+    updateCachedRates();
 }
 
 bool BondInvestment::isCallable() const {
@@ -93,6 +204,40 @@ bool BondInvestment::isCallable() const {
 
 void BondInvestment::setCallable(bool isCallable) {
     callable = isCallable;
+    updateCachedRates();
+}
+
+void BondInvestment::setTerms(double rate, int years, double inflation, bool isCallable) {
+    if (yieldCurve)
+        throw InvestmentException("Interest rate is set by the yield curve");
+    if (rate < 0.0)
+        throw InvestmentException("Interest rate cannot be negative");
+    if (years <= 0)
+        throw InvestmentException("Term years must be positive");
+    if (inflation < 0.0)
+        throw InvestmentException("Inflation rate cannot be negative");
+    interestRate = rate;
+    termYears = years;
+    inflationRate = inflation;
+    callable = isCallable;
+    updateCachedRates();
+}
+
+void BondInvestment::setYieldCurve(std::shared_ptr<YieldCurve> curve) {
+    if (curve && termYears > curve->getHorizonYears())
+        throw InvestmentException("Term years are beyond the curve horizon");
+    if (curve == yieldCurve)
+        return;
+    if (yieldCurve)
+        yieldCurve->detach(*this);
+    yieldCurve = std::move(curve);
+    if (yieldCurve)
+        yieldCurve->attach(*this);
+    updateCachedRates();
+}
+
+std::shared_ptr<YieldCurve> BondInvestment::getYieldCurve() const {
+    return yieldCurve;
 }
 
 double BondInvestment::getCallableAdjustment() const {
@@ -104,6 +249,7 @@ void BondInvestment::setCallableAdjustment(double adj) {
         callableAdjustment = adj;
     else
         throw InvestmentException("Callable adjustment must be in (0, 1]");
+    updateCachedRates();
 }
 
 double BondInvestment::getBaseRiskWeight() const {
@@ -115,6 +261,7 @@ void BondInvestment::setBaseRiskWeight(double weight) {
         baseRiskWeight = weight;
     else
         throw InvestmentException("Base risk weight cannot be negative");
+    updateFingerprint();
 }
 
 double BondInvestment::getInflationAdjustment() const {
@@ -126,16 +273,23 @@ void BondInvestment::setInflationAdjustment(double adj) {
         inflationAdjustment = adj;
     else
         throw InvestmentException("Inflation adjustment must be positive");
+    updateCachedRates();
 }
 
-std::string BondInvestment::getInvestmentDetails(double amount) const {
-    std::stringstream ss;
-    ss << InvestmentStrategy::getInvestmentDetails(amount)
-       << " with " << interestRate * 100 << "% nominal interest over "
-       << termYears << " years, Inflation Rate: " << inflationRate * 100
-       << "%, Callable: " << (callable ? "Yes" : "No")
-       << ", Callable Adjustment: " << callableAdjustment
-       << ", Base Risk Weight: " << baseRiskWeight
-       << ", Inflation Adjustment: " << inflationAdjustment;
-    return ss.str();
+void BondInvestment::appendInvestmentDetails(std::string& out, double amount) const {
+    InvestmentStrategy::appendInvestmentDetails(out, amount);
+    out += " with ";
+    appendNumber(out, interestRate * 100);
+    out += "% nominal interest over ";
+    appendInteger(out, termYears);
+    out += " years, Inflation Rate: ";
+    appendNumber(out, inflationRate * 100);
+    out += "%, Callable: ";
+    out += callable ? "Yes" : "No";
+    out += ", Callable Adjustment: ";
+    appendNumber(out, callableAdjustment);
+    out += ", Base Risk Weight: ";
+    appendNumber(out, baseRiskWeight);
+    out += ", Inflation Adjustment: ";
+    appendNumber(out, inflationAdjustment);
 }
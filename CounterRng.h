@@ -0,0 +1,51 @@
+#ifndef COUNTER_RNG_H
+#define COUNTER_RNG_H
+
+#include <cmath>
+#include <cstdint>
+
+// Counter-based random stream: every draw is a pure function of (key, counter),
+// so a stream can be recreated on any thread without sharing generator state.
+class CounterRng {
+public:
+    CounterRng(std::uint64_t seed, std::uint64_t streamId)
+        : key(mix(seed ^ mix(streamId + 0x9E3779B97F4A7C15ULL))), counter(0),
+          hasSpare(false), spare(0.0) {}
+
+    static std::uint64_t mix(std::uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    std::uint64_t nextBits() {
+        return mix(key + (counter++) * 0x9E3779B97F4A7C15ULL);
+    }
+
+    // Uniform in the open interval (0, 1)
+    double nextUniform() {
+        return (static_cast<double>(nextBits() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    }
+
+    // Standard normal via Box-Muller; the second variate of each pair is cached
+    double nextNormal() {
+        if (hasSpare) {
+            hasSpare = false;
+            return spare;
+        }
+        const double twoPi = 6.283185307179586476925286766559;
+        double radius = std::sqrt(-2.0 * std::log(nextUniform()));
+        double angle = twoPi * nextUniform();
+        spare = radius * std::sin(angle);
+        hasSpare = true;
+        return radius * std::cos(angle);
+    }
+
+private:
+    std::uint64_t key;
+    std::uint64_t counter;
+    bool hasSpare;
+    double spare;
+};
+
+#endif // COUNTER_RNG_H
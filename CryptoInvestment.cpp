@@ -0,0 +1,256 @@
+#include "InvestmentSimulator.h"
+#include "CounterRng.h"
+#include "DetailFormat.h"
+#include "FastMath.h"
+#include "Metrics.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <typeinfo>
+#include <vector>
+
+CryptoInvestment::CryptoInvestment(const std::string& name, double volatility, double hype,
+                                   double jumpRate, double jumpMeanSize, double jumpVol)
+    : InvestmentStrategy("Crypto", 0.9), cryptoName(name), cryptoVolatility(volatility), hypeFactor(hype),
+      jumpIntensity(jumpRate), jumpMean(jumpMeanSize), jumpVolatility(jumpVol)
+{
+    if (name.empty())
+        throw InvestmentException("Crypto name cannot be empty");
+    if (volatility < 0.0)
+        throw InvestmentException("Crypto volatility cannot be negative");
+    if (hype < 0.0)
+        throw InvestmentException("Hype factor cannot be negative");
+    if (jumpRate < 0.0)
+        throw InvestmentException("Jump intensity cannot be negative");
+    if (jumpVol < 0.0)
+        throw InvestmentException("Jump volatility cannot be negative");
+    updateFingerprint();
+}
+
+double CryptoInvestment::getDriftRate() const {
+    return hypeFactor * 0.1;
+}
+
+InvestmentResult CryptoInvestment::tryInvest(double amount) const {
+    INVESTMENT_METRIC_COUNT(MetricStrategyInvestments);
+    INVESTMENT_METRIC_TIME(MetricStrategyInvestLatency);
+    if (amount <= 0) {
+        INVESTMENT_METRIC_COUNT(MetricInvalidAmount);
+        return InvestmentResult::failure(StatusInvalidAmount);
+    }
+    return InvestmentResult::success(amount * std::exp(getDriftRate()));
+}
+
+InvestmentResult CryptoInvestment::tryCalculatePotentialReturn(double amount) const {
+    if (amount <= 0)
+        return InvestmentResult::failure(StatusInvalidAmount);
+    return InvestmentResult::success(amount * std::exp(getDriftRate()) - amount);
+}
+
+double CryptoInvestment::calculateRisk() const {
+    return riskRating * 1.5 + cryptoVolatility + jumpIntensity * jumpVolatility;
+}
+
+void CryptoInvestment::investBatch(const double* amounts, double* out, std::size_t n) const {
+    if (typeid(*this) != typeid(CryptoInvestment)) {
+        InvestmentStrategy::investBatch(amounts, out, n);   // a subclass may override invest()
+        return;
+    }
+    validateBatch(amounts, out, n);
+    const double growth = std::exp(getDriftRate());
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = amounts[i] * growth;
+}
+
+// Paths are generated in blocks of fixed size, one branch-free loop per stage over plain arrays:
+// counter hashing and Box-Muller, Poisson counting against a CDF table, then the exponential.
+// The final block is computed in full and truncated, so every stage has a constant trip count
+// and vectorizes even under -O2's cost model.
+void CryptoInvestment::sampleTerminalValues(double amount, double horizonYears, std::uint64_t seed,
+                                            std::uint64_t firstPath, double* out, std::size_t n) const {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    if (horizonYears <= 0.0)
+        throw InvestmentException("Simulation horizon must be positive");
+    if (!out && n != 0)
+        throw InvestmentException("Batch buffers cannot be null");
+
+    const std::uint64_t increment = 0x9E3779B97F4A7C15ULL;
+    const double twoPi = 6.283185307179586476925286766559;
+    const double sigma = cryptoVolatility;
+    const double compensator = jumpIntensity * (std::exp(jumpMean + 0.5 * jumpVolatility * jumpVolatility) - 1.0);
+    const double drift = (getDriftRate() - compensator - 0.5 * sigma * sigma) * horizonYears;
+    const double diffusion = sigma * std::sqrt(horizonYears);
+    const double jumpSpread = jumpVolatility;
+    const double jumpLocation = jumpMean;
+
+    // cdf[k] = P(jumps <= k); a path's jump count is the number of entries its uniform exceeds
+    const double expectedJumps = jumpIntensity * horizonYears;
+    std::vector<double> cdf;
+    double probability = std::exp(-expectedJumps);
+    double cumulative = probability;
+    cdf.push_back(cumulative);
+    for (int k = 1; k < 512 && 1.0 - cumulative > 1e-15; ++k) {
+        probability *= expectedJumps / k;
+        cumulative += probability;
+        cdf.push_back(cumulative);
+    }
+    // Past about 360 expected jumps the table no longer reaches the upper tail, and past about
+    // 745 e^-expectedJumps underflows; either way every path would be capped at the table size
+    if (1.0 - cumulative > 1e-12)
+        throw InvestmentException("Too many expected jumps over the horizon to sample");
+    if (n == 0)
+        return;
+    const double* cdfTable = cdf.data();
+    const std::size_t cdfSize = cdf.size();
+
+    const std::size_t blockSize = 256;
+    double diffusionShock[blockSize];
+    double jumpShock[blockSize];
+    double jumpUniform[blockSize];
+    double jumpCount[blockSize];
+    double growth[blockSize];
+
+    for (std::size_t base = 0; base < n; base += blockSize) {
+        const std::size_t count = std::min(blockSize, n - base);
+
+        for (std::size_t i = 0; i < blockSize; ++i) {
+            // Same per-path key schedule as CounterRng; uniforms take the top 52 bits, and u1 is
+            // shifted by half a step so the log never sees zero
+            std::uint64_t key = CounterRng::mix(seed ^ CounterRng::mix(firstPath + base + i + increment));
+            double u1 = fastMathFromBits(0x3FF0000000000000ULL | (CounterRng::mix(key) >> 12)) - 1.0
+                      + 1.1102230246251565e-16;
+            double u2 = fastMathFromBits(0x3FF0000000000000ULL | (CounterRng::mix(key + increment) >> 12)) - 1.0;
+            double u3 = fastMathFromBits(0x3FF0000000000000ULL | (CounterRng::mix(key + 2 * increment) >> 12)) - 1.0;
+            double radius = std::sqrt(-2.0 * fastLog(u1));
+            double sine, cosine;
+            fastSinCos(twoPi * u2 - 3.141592653589793238462643383280, sine, cosine);
+            diffusionShock[i] = radius * cosine;
+            jumpShock[i] = radius * sine;
+            jumpUniform[i] = u3;
+            jumpCount[i] = 0.0;
+        }
+
+        for (std::size_t k = 0; k < cdfSize; ++k) {
+            const double threshold = cdfTable[k];
+            for (std::size_t i = 0; i < blockSize; ++i)
+                jumpCount[i] += jumpUniform[i] > threshold ? 1.0 : 0.0;
+        }
+
+        // The sum of N normal log-jumps is normal with mean N * jumpMean and deviation sqrt(N) * jumpVolatility
+        for (std::size_t i = 0; i < blockSize; ++i) {
+            double logGrowth = drift + diffusion * diffusionShock[i] + jumpCount[i] * jumpLocation
+                             + std::sqrt(jumpCount[i]) * jumpSpread * jumpShock[i];
+            logGrowth = logGrowth < -708.0 ? -708.0 : logGrowth;
+            growth[i] = logGrowth > 709.0 ? 709.0 : logGrowth;
+        }
+        for (std::size_t i = 0; i < blockSize; ++i)
+            growth[i] = fastExp(growth[i]);
+        for (std::size_t i = 0; i < count; ++i)
+            out[base + i] = amount * growth[i];
+    }
+}
+
+MonteCarloResult CryptoInvestment::simulate(double amount, const MonteCarloSettings& settings) const {
+    return simulate(amount, settings, ThreadPool::shared());
+}
+
+MonteCarloResult CryptoInvestment::simulate(double amount, const MonteCarloSettings& settings, ThreadPool& pool) const {
+    validateSimulation(amount, settings);
+
+    std::vector<double> terminal(settings.paths);
+    pool.parallelFor(settings.paths, 4096, [&](std::size_t begin, std::size_t end) {
+        sampleTerminalValues(amount, settings.horizonYears, settings.seed, begin, &terminal[begin], end - begin);
+    });
+
+    return summarizeTerminalValues(terminal, amount, settings.confidence);
+}
+
+ParameterFingerprint CryptoInvestment::computeFingerprint() const {
+    ParameterFingerprint hash = InvestmentStrategy::computeFingerprint();
+    hash = mixFingerprint(hash, cryptoVolatility);
+    hash = mixFingerprint(hash, hypeFactor);
+    hash = mixFingerprint(hash, jumpIntensity);
+    hash = mixFingerprint(hash, jumpMean);
+    return mixFingerprint(hash, jumpVolatility);
+}
+
+std::string CryptoInvestment::getCryptoName() const {
+    return cryptoName;
+}
+
+void CryptoInvestment::setCryptoName(const std::string& name) {
+    if (!name.empty())
+        cryptoName = name;
+    else
+        throw InvestmentException("Crypto name cannot be empty");
+}
+
+double CryptoInvestment::getCryptoVolatility() const {
+    return cryptoVolatility;
+}
+
+void CryptoInvestment::setCryptoVolatility(double volatility) {
+    if (volatility >= 0.0)
+        cryptoVolatility = volatility;
+    else
+        throw InvestmentException("Crypto volatility cannot be negative");
+    updateFingerprint();
+}
+
+double CryptoInvestment::getHypeFactor() const {
+    return hypeFactor;
+}
+
+void CryptoInvestment::setHypeFactor(double hype) {
+    if (hype >= 0.0)
+        hypeFactor = hype;
+    else
+        throw InvestmentException("Hype factor cannot be negative");
+    updateFingerprint();
+}
+
+double CryptoInvestment::getJumpIntensity() const {
+    return jumpIntensity;
+}
+
+void CryptoInvestment::setJumpIntensity(double jumpRate) {
+    if (jumpRate >= 0.0)
+        jumpIntensity = jumpRate;
+    else
+        throw InvestmentException("Jump intensity cannot be negative");
+    updateFingerprint();
+}
+
+double CryptoInvestment::getJumpMean() const {
+    return jumpMean;
+}
+
+void CryptoInvestment::setJumpMean(double jumpMeanSize) {
+    jumpMean = jumpMeanSize;
+    updateFingerprint();
+}
+
+double CryptoInvestment::getJumpVolatility() const {
+    return jumpVolatility;
+}
+
+void CryptoInvestment::setJumpVolatility(double jumpVol) {
+    if (jumpVol >= 0.0)
+        jumpVolatility = jumpVol;
+    else
+        throw InvestmentException("Jump volatility cannot be negative");
+    updateFingerprint();
+}
+
+void CryptoInvestment::appendInvestmentDetails(std::string& out, double amount) const {
+    InvestmentStrategy::appendInvestmentDetails(out, amount);
+    out += " in ";
+    out += cryptoName;
+    out += ", Volatility: ";
+    appendNumber(out, cryptoVolatility);
+    out += ", Hype Factor: ";
+    appendNumber(out, hypeFactor);
+    out += ", Jump Intensity: ";
+    appendNumber(out, jumpIntensity);
+    out += " per year";
+}
@@ -0,0 +1,96 @@
+#include "DetailFormat.h"
+#include <cmath>
+#include <cstdio>
+
+void appendInteger(std::string& out, long long value) {
+    char buffer[24];
+    char* end = buffer + sizeof(buffer);
+    char* cursor = end;
+    unsigned long long magnitude = value < 0 ? 0ULL - static_cast<unsigned long long>(value)
+                                             : static_cast<unsigned long long>(value);
+    do {
+        *--cursor = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude != 0);
+    if (value < 0)
+        *--cursor = '-';
+    out.append(cursor, end - cursor);
+}
+
+namespace {
+
+// Exact powers of ten 10^0 .. 10^9, used as scale factors
+const double exactPowers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9};
+// Lower bounds of each decimal exponent -4 .. 5
+const double exponentFloors[] = {1e-4, 1e-3, 1e-2, 1e-1, 1e0, 1e1, 1e2, 1e3, 1e4, 1e5};
+
+// %g with six significant digits for decimal exponents -4..5, i.e. the range %g prints
+// in fixed notation. Returns false when the value must go through snprintf instead.
+bool appendFixedSignificant(std::string& out, double value) {
+    double magnitude = std::fabs(value);
+    if (!(magnitude >= 1e-4 && magnitude < 1e6))
+        return false;
+
+    int exponent = 5;
+    while (exponent > -4 && magnitude < exponentFloors[exponent + 4])
+        --exponent;
+    // Scaling by an exact power of ten costs at most half an ulp, so only near-ties are ambiguous
+    double scaled = magnitude * exactPowers[5 - exponent];
+    if (scaled < 1e5) {
+        if (exponent == -4)
+            return false;
+        --exponent;
+        scaled = magnitude * exactPowers[5 - exponent];
+    }
+    if (std::fabs(scaled - std::floor(scaled) - 0.5) < 1e-6)
+        return false;
+    double rounded = std::floor(scaled + 0.5);
+    if (rounded >= 1e6) {
+        if (exponent == 5)
+            return false;
+        ++exponent;
+        rounded /= 10;
+    }
+
+    char digits[6];
+    long mantissa = static_cast<long>(rounded);
+    for (int i = 5; i >= 0; --i) {
+        digits[i] = static_cast<char>('0' + mantissa % 10);
+        mantissa /= 10;
+    }
+    int significant = 6;
+    while (significant > 1 && digits[significant - 1] == '0')
+        --significant;
+
+    if (value < 0)
+        out += '-';
+    if (exponent >= 0) {
+        int integerDigits = exponent + 1;
+        out.append(digits, integerDigits);
+        if (significant > integerDigits) {
+            out += '.';
+            out.append(digits + integerDigits, significant - integerDigits);
+        }
+    } else {
+        out += "0.";
+        out.append(static_cast<std::size_t>(-exponent - 1), '0');
+        out.append(digits, significant);
+    }
+    return true;
+}
+
+} // namespace
+
+void appendNumber(std::string& out, double value) {
+    // Whole numbers below 1e6 print without a decimal point or exponent under %g
+    if (std::fabs(value) < 1e6 && value == std::floor(value) && !(value == 0.0 && std::signbit(value))) {
+        appendInteger(out, static_cast<long long>(value));
+        return;
+    }
+    if (appendFixedSignificant(out, value))
+        return;
+    char buffer[32];
+    int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    if (length > 0)
+        out.append(buffer, static_cast<std::size_t>(length));
+}
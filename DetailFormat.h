@@ -0,0 +1,11 @@
+#ifndef DETAIL_FORMAT_H
+#define DETAIL_FORMAT_H
+
+#include <string>
+
+// Append numbers to a string exactly as a default-configured std::ostream would print them,
+// without a stream, locale lookup or temporary string.
+void appendNumber(std::string& out, double value);
+void appendInteger(std::string& out, long long value);
+
+#endif // DETAIL_FORMAT_H
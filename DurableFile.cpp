@@ -0,0 +1,94 @@
+#include "DurableFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+int openFile(const std::string& path, bool truncate) {
+    return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (truncate ? _O_TRUNC : _O_APPEND),
+                 _S_IREAD | _S_IWRITE);
+}
+
+bool syncFile(int fd) {
+    return _commit(fd) == 0;
+}
+
+bool truncateFile(int fd, std::size_t size) {
+    return _chsize_s(fd, static_cast<long long>(size)) == 0;
+}
+
+void closeFile(int fd) {
+    _close(fd);
+}
+
+bool replaceFile(const std::string& from, const std::string& to) {
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+}
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        int written = _write(fd, data, static_cast<unsigned int>(size < 0x40000000 ? size : 0x40000000));
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+#else
+
+int openFile(const std::string& path, bool truncate) {
+    return ::open(path.c_str(), O_WRONLY | O_CREAT | (truncate ? O_TRUNC : O_APPEND), 0644);
+}
+
+bool syncFile(int fd) {
+#if defined(__linux__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+bool truncateFile(int fd, std::size_t size) {
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0;
+}
+
+void closeFile(int fd) {
+    ::close(fd);
+}
+
+// The rename is only durable once the directory holding it is synced
+bool replaceFile(const std::string& from, const std::string& to) {
+    if (::rename(from.c_str(), to.c_str()) != 0)
+        return false;
+    std::size_t slash = to.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : to.substr(0, slash));
+    int dirFd = ::open(directory.c_str(), O_RDONLY);
+    if (dirFd < 0)
+        return false;
+    bool ok = ::fsync(dirFd) == 0;
+    ::close(dirFd);
+    return ok;
+}
+
+bool writeAll(int fd, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written <= 0)
+            return false;
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef DURABLE_FILE_H
+#define DURABLE_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Thin wrappers over the platform file calls the journal and the bank snapshot use to write files
+// that survive a crash: write a temporary file, sync it, then replace the old file with it.
+// Failures are reported as false (or a negative descriptor) for the caller to turn into an
+// exception naming the file.
+
+// Opens for writing, creating the file; truncate empties it, otherwise writes append
+int openFile(const std::string& path, bool truncate);
+bool writeAll(int fd, const char* data, std::size_t size);
+bool syncFile(int fd);
+bool truncateFile(int fd, std::size_t size);
+void closeFile(int fd);
+// Atomically renames from over to, and waits until the rename itself is durable
+bool replaceFile(const std::string& from, const std::string& to);
+
+#endif // DURABLE_FILE_H
@@ -0,0 +1,72 @@
+#ifndef FAST_MATH_H
+#define FAST_MATH_H
+
+#include <cstdint>
+#include <cstring>
+
+// Branch-free log/exp/sin/cos built from integer bit manipulation and polynomials.
+// They inline into simulation loops, so the compiler can vectorize them where libm
+// calls would stop it. Over the documented ranges log and exp are accurate to about 1e-15
+// relative, and sin and cos to about 4e-15 absolute.
+
+inline std::uint64_t fastMathBits(double x) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double fastMathFromBits(std::uint64_t bits) {
+    double x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Natural log for positive, normal x
+inline double fastLog(double x) {
+    const double ln2 = 0.69314718055994530942;
+    // Offsetting the bits splits x into 2^k * m with m in [sqrt(1/2), sqrt(2)) using only
+    // integer operations, so there is no compare for the compiler to turn into a branch
+    const std::uint64_t sqrtHalfBits = 0x3FE6A09E667F3BCDULL;
+    std::uint64_t shifted = fastMathBits(x) + (0x3FF0000000000000ULL - sqrtHalfBits);
+    double exponent = fastMathFromBits(0x4330000000000000ULL | (shifted >> 52)) - (4503599627370496.0 + 1023.0);
+    double m = fastMathFromBits((shifted & 0x000FFFFFFFFFFFFFULL) + sqrtHalfBits);
+    double s = (m - 1.0) / (m + 1.0);
+    double s2 = s * s;
+    double series = 1.0 + s2 * (1.0 / 3 + s2 * (1.0 / 5 + s2 * (1.0 / 7 + s2 * (1.0 / 9 + s2 * (1.0 / 11 +
+                     s2 * (1.0 / 13 + s2 * (1.0 / 15 + s2 * (1.0 / 17))))))));
+    return exponent * ln2 + 2.0 * s * series;
+}
+
+// e^x for x in [-708, 709]; callers clamp, since a select inside the polynomial loop
+// defeats if-conversion
+inline double fastExp(double x) {
+    const double log2e = 1.4426950408889634074;
+    const double ln2High = 0.693147180369123816490;
+    const double ln2Low = 1.90821492927058770002e-10;
+    const double roundMagic = 6755399441055744.0;   // 1.5 * 2^52
+    double shifted = x * log2e + roundMagic;
+    double n = shifted - roundMagic;
+    std::int64_t k = static_cast<std::int64_t>(fastMathBits(shifted) & 0x000FFFFFFFFFFFFFULL) - (1LL << 51);
+    double r = (x - n * ln2High) - n * ln2Low;
+    double p = 1.0 + r * (1.0 + r * (1.0 / 2 + r * (1.0 / 6 + r * (1.0 / 24 + r * (1.0 / 120 + r * (1.0 / 720 +
+               r * (1.0 / 5040 + r * (1.0 / 40320 + r * (1.0 / 362880 + r * (1.0 / 3628800 +
+               r * (1.0 / 39916800 + r * (1.0 / 479001600))))))))))));
+    return p * fastMathFromBits(static_cast<std::uint64_t>(k + 1023) << 52);
+}
+
+// sin and cos for x in [-pi, pi]
+inline void fastSinCos(double x, double& sine, double& cosine) {
+    double x2 = x * x;
+    sine = x * (1.0 - x2 * (1.0 / 6 - x2 * (1.0 / 120 - x2 * (1.0 / 5040 - x2 * (1.0 / 362880 -
+           x2 * (1.0 / 39916800 - x2 * (1.0 / 6227020800.0 - x2 * (1.0 / 1307674368000.0 -
+           x2 * (1.0 / 355687428096000.0 - x2 * (1.0 / 121645100408832000.0 -
+           x2 * (1.0 / 51090942171709440000.0 - x2 * (1.0 / 25852016738884976640000.0 -
+           x2 * (1.0 / 15511210043330985984000000.0)))))))))))));
+    cosine = 1.0 - x2 * (1.0 / 2 - x2 * (1.0 / 24 - x2 * (1.0 / 720 - x2 * (1.0 / 40320 -
+             x2 * (1.0 / 3628800 - x2 * (1.0 / 479001600 - x2 * (1.0 / 87178291200.0 -
+             x2 * (1.0 / 20922789888000.0 - x2 * (1.0 / 6402373705728000.0 -
+             x2 * (1.0 / 2432902008176640000.0 - x2 * (1.0 / 1124000727777607680000.0 -
+             x2 * (1.0 / 620448401733239439360000.0 - x2 * (1.0 / 403291461126605635584000000.0)))))))))))));
+}
+
+#endif // FAST_MATH_H
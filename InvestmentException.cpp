@@ -1,4 +1,29 @@
 #include "InvestmentSimulator.h"
+#include "Metrics.h"
+
+const char* statusMessage(InvestmentStatus status) {
+    switch (status) {
+    case StatusOk: return "Success";
+    case StatusInvalidAmount: return "Investment amount must be positive";
+    case StatusInvalidDeposit: return "Deposit amount must be positive";
+    case StatusInvalidWithdrawal: return "Withdrawal amount must be positive";
+    case StatusNoStrategy: return "No investment strategy set";
+    case StatusInsufficientFunds: return "Insufficient funds for investment";
+    case StatusStrategyFailed: return "Investment strategy failed";
+    default: return "Unknown status";
+    }
+}
 
 InvestmentException::InvestmentException(const std::string& message)
-    : std::runtime_error(message) {}
+    : std::runtime_error(message) {
+    INVESTMENT_METRIC_COUNT(MetricExceptions);
+}
+
+InvestmentException::InvestmentException(InvestmentStatus status)
+    : std::runtime_error(statusMessage(status)) {
+    INVESTMENT_METRIC_COUNT(MetricExceptions);
+}
+
+void throwInvestmentStatus(InvestmentStatus status) {
+    throw InvestmentException(status);
+}
@@ -0,0 +1,267 @@
+#include "InvestmentPipeline.h"
+#include <algorithm>
+
+InvestmentPipeline::InvestmentPipeline(const PipelineOptions& pipelineOptions)
+    : options(pipelineOptions), mask(0), tail(0), head(0), consumerWaiting(false), producersWaiting(0),
+      stopping(false), submittedCount(0), completedCount(0), batchCount(0) {
+    if (options.queueCapacity == 0)
+        throw InvestmentException("Queue capacity must be positive");
+    if (options.maxBatch == 0)
+        options.maxBatch = 1;
+    std::size_t capacity = 2;
+    while (capacity < options.queueCapacity)
+        capacity *= 2;
+    mask = capacity - 1;
+    slots.reset(new Slot[capacity]);
+    for (std::size_t i = 0; i < capacity; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    batch.reserve(options.maxBatch);
+    worker = std::thread(&InvestmentPipeline::run, this);
+}
+
+InvestmentPipeline::~InvestmentPipeline() {
+    stopping.store(true);
+    wakeConsumer();
+    worker.join();
+}
+
+// Bounded queue after Vyukov: a producer claims a position with a CAS on the tail, fills the
+// slot, then publishes it by advancing the slot's sequence. Moves the request only on success;
+// callers then wake the consumer if it is waiting.
+bool InvestmentPipeline::tryEnqueue(Request& request) {
+    std::size_t position = tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots[position & mask];
+        std::size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t lag = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (lag == 0) {
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        } else if (lag < 0) {
+            return false;       // the consumer has not freed this slot yet: full
+        } else {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+    slot->request = std::move(request);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    submittedCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// Pairs with the fence in run(): either the consumer sees the new request or we see it waiting
+bool InvestmentPipeline::consumerNeedsWake() const {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return consumerWaiting.load(std::memory_order_relaxed);
+}
+
+void InvestmentPipeline::enqueue(Request& request) {
+    if (tryEnqueue(request)) {
+        if (consumerNeedsWake())
+            wakeConsumer();
+        return;
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    producersWaiting.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (!tryEnqueue(request))
+        spaceAvailable.wait(lock);
+    producersWaiting.fetch_sub(1);
+    if (consumerNeedsWake())
+        itemsAvailable.notify_one();
+}
+
+bool InvestmentPipeline::tryDequeue(Request& request) {
+    Slot& slot = slots[head & mask];
+    if (slot.sequence.load(std::memory_order_acquire) != head + 1)
+        return false;
+    request = std::move(slot.request);
+    slot.sequence.store(head + mask + 1, std::memory_order_release);
+    ++head;
+    return true;
+}
+
+bool InvestmentPipeline::queueEmpty() const {
+    return slots[head & mask].sequence.load(std::memory_order_acquire) != head + 1;
+}
+
+void InvestmentPipeline::wakeConsumer() {
+    std::lock_guard<std::mutex> lock(mutex);
+    itemsAvailable.notify_one();
+}
+
+std::future<InvestmentResult> InvestmentPipeline::submit(Bank& bank, double amount) {
+    Request request;
+    request.bank = &bank;
+    request.amount = amount;
+    request.promise.reset(new std::promise<InvestmentResult>());
+    std::future<InvestmentResult> result = request.promise->get_future();
+    enqueue(request);
+    return result;
+}
+
+void InvestmentPipeline::submit(Bank& bank, double amount, InvestmentCallback callback) {
+    Request request;
+    request.bank = &bank;
+    request.amount = amount;
+    request.callback = std::move(callback);
+    enqueue(request);
+}
+
+bool InvestmentPipeline::trySubmit(Bank& bank, double amount, InvestmentCallback callback) {
+    Request request;
+    request.bank = &bank;
+    request.amount = amount;
+    request.callback = std::move(callback);
+    if (!tryEnqueue(request))
+        return false;
+    if (consumerNeedsWake())
+        wakeConsumer();
+    return true;
+}
+
+void InvestmentPipeline::flush() {
+    const std::uint64_t target = submittedCount.load();
+    std::unique_lock<std::mutex> lock(mutex);
+    batchCompleted.wait(lock, [this, target] { return completedCount.load() >= target; });
+}
+
+std::uint64_t InvestmentPipeline::submitted() const {
+    return submittedCount.load();
+}
+
+std::uint64_t InvestmentPipeline::completed() const {
+    return completedCount.load();
+}
+
+std::uint64_t InvestmentPipeline::batches() const {
+    return batchCount.load();
+}
+
+void InvestmentPipeline::run() {
+    Request request;
+    for (;;) {
+        // Sleep until the first request of a batch arrives
+        while (!tryDequeue(request)) {
+            if (stopping.load())
+                return;
+            std::unique_lock<std::mutex> lock(mutex);
+            consumerWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (queueEmpty() && !stopping.load())
+                itemsAvailable.wait(lock);
+            consumerWaiting.store(false, std::memory_order_relaxed);
+        }
+        batch.push_back(std::move(request));
+
+        // Then top the batch up until it is full or the flush deadline passes
+        const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + options.maxDelay;
+        while (batch.size() < options.maxBatch) {
+            if (tryDequeue(request)) {
+                batch.push_back(std::move(request));
+                continue;
+            }
+            if (stopping.load() || std::chrono::steady_clock::now() >= deadline)
+                break;
+            std::unique_lock<std::mutex> lock(mutex);
+            consumerWaiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (queueEmpty() && !stopping.load())
+                itemsAvailable.wait_until(lock, deadline);
+            consumerWaiting.store(false, std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (producersWaiting.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            spaceAvailable.notify_all();
+        }
+
+        process();
+        const std::size_t done = batch.size();
+        batch.clear();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            completedCount.fetch_add(done);
+            batchCount.fetch_add(1);
+        }
+        batchCompleted.notify_all();
+    }
+}
+
+// Checks and reserves funds request by request, then values each strategy's requests with one
+// investBatch call
+void InvestmentPipeline::process() {
+    const std::size_t n = batch.size();
+    strategies.resize(n);
+    order.clear();
+    for (std::size_t i = 0; i < n; ++i) {
+        Request& request = batch[i];
+        strategies[i] = request.bank->getStrategy();
+        if (!strategies[i]) {
+            complete(request, InvestmentResult::failure(StatusNoStrategy));
+            continue;
+        }
+        // Same checks and order as Bank::investWith, which also rejects NaN as invalid
+        InvestmentStatus status = StatusInvalidAmount;
+        if (request.amount > 0)
+            status = request.bank->tryWithdrawFunds(request.amount);
+        if (status == StatusInvalidWithdrawal)
+            status = StatusInvalidAmount;
+        if (status == StatusOk)
+            order.push_back(i);
+        else
+            complete(request, InvestmentResult::failure(status));
+    }
+    // Arrival order within a strategy; stable_sort would allocate a buffer per batch
+    std::sort(order.begin(), order.end(), [this](std::size_t a, std::size_t b) {
+        const InvestmentStrategy* left = strategies[a].get();
+        const InvestmentStrategy* right = strategies[b].get();
+        return left < right || (left == right && a < b);
+    });
+
+    for (std::size_t begin = 0; begin < order.size();) {
+        const InvestmentStrategy* strategy = strategies[order[begin]].get();
+        std::size_t end = begin + 1;
+        while (end < order.size() && strategies[order[end]].get() == strategy)
+            ++end;
+        const std::size_t count = end - begin;
+        amounts.resize(count);
+        values.resize(count);
+        for (std::size_t k = 0; k < count; ++k)
+            amounts[k] = batch[order[begin + k]].amount;
+        bool valued = true;
+        try {
+            strategy->investBatch(amounts.data(), values.data(), count);
+        } catch (...) {
+            valued = false;
+        }
+        for (std::size_t k = 0; k < count; ++k) {
+            Request& request = batch[order[begin + k]];
+            if (valued) {
+                complete(request, InvestmentResult::success(values[k]));
+            } else {
+                request.bank->depositFunds(request.amount);
+                complete(request, InvestmentResult::failure(StatusStrategyFailed));
+            }
+        }
+        begin = end;
+    }
+    strategies.clear();
+}
+
+// Exceptions from callbacks are dropped so one client cannot stop the pipeline
+void InvestmentPipeline::complete(Request& request, const InvestmentResult& result) {
+    if (request.promise) {
+        request.promise->set_value(result);
+        request.promise.reset();
+        return;
+    }
+    if (request.callback) {
+        try {
+            request.callback(result);
+        } catch (...) {
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef INVESTMENT_PIPELINE_H
+#define INVESTMENT_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+struct PipelineOptions {
+    std::size_t queueCapacity;              // rounded up to a power of two
+    std::size_t maxBatch;                   // requests taken per pass
+    std::chrono::microseconds maxDelay;     // how long a partial batch waits for more requests
+
+    PipelineOptions(std::size_t capacity = 4096, std::size_t batch = 256,
+                    std::chrono::microseconds delay = std::chrono::microseconds(200))
+        : queueCapacity(capacity), maxBatch(batch), maxDelay(delay) {}
+};
+
+typedef std::function<void(const InvestmentResult& result)> InvestmentCallback;
+
+// Asynchronous front end for Bank::executeInvestment. Requests go into a bounded lock-free
+// multi-producer queue; one pipeline thread takes them in micro-batches, reserves each bank's
+// funds, groups the requests by strategy and values each group with a single investBatch call.
+// Results, including rejections, arrive through a future or a callback run on the pipeline thread
+// (callbacks must not block or submit to a full pipeline). Funds and statuses are the same as
+// for Bank::tryExecuteInvestment; a strategy that throws fails its group with StatusStrategyFailed
+// and the funds are returned. Banks must outlive their requests; the destructor completes every
+// request already accepted.
+class InvestmentPipeline {
+public:
+    explicit InvestmentPipeline(const PipelineOptions& options = PipelineOptions());
+    ~InvestmentPipeline();
+
+    InvestmentPipeline(const InvestmentPipeline&) = delete;
+    InvestmentPipeline& operator=(const InvestmentPipeline&) = delete;
+
+    // Both block while the queue is full (backpressure)
+    std::future<InvestmentResult> submit(Bank& bank, double amount);
+    void submit(Bank& bank, double amount, InvestmentCallback callback);
+    // Returns false instead of blocking when the queue is full
+    bool trySubmit(Bank& bank, double amount, InvestmentCallback callback);
+
+    // Waits until every request submitted before the call has completed
+    void flush();
+
+    std::uint64_t submitted() const;
+    std::uint64_t completed() const;
+    std::uint64_t batches() const;
+
+private:
+    struct Request {
+        Bank* bank;
+        double amount;
+        InvestmentCallback callback;
+        std::unique_ptr<std::promise<InvestmentResult> > promise;     // set only for submissions by future
+    };
+
+    // Slot sequence numbers tell producers and the consumer whose turn a slot is
+    struct Slot {
+        std::atomic<std::size_t> sequence;
+        Request request;
+    };
+
+    bool tryEnqueue(Request& request);
+    void enqueue(Request& request);
+    bool tryDequeue(Request& request);
+    bool queueEmpty() const;
+    bool consumerNeedsWake() const;
+    void wakeConsumer();
+    void run();
+    void process();
+    void complete(Request& request, const InvestmentResult& result);
+
+    PipelineOptions options;
+    std::unique_ptr<Slot[]> slots;
+    std::size_t mask;
+    char padding[64];
+    std::atomic<std::size_t> tail;          // next position producers claim
+    char tailPadding[64];
+    std::size_t head;                       // pipeline thread only
+
+    std::mutex mutex;
+    std::condition_variable itemsAvailable;
+    std::condition_variable spaceAvailable;
+    std::condition_variable batchCompleted;
+    std::atomic<bool> consumerWaiting;
+    std::atomic<int> producersWaiting;
+    std::atomic<bool> stopping;
+
+    std::atomic<std::uint64_t> submittedCount;
+    std::atomic<std::uint64_t> completedCount;
+    std::atomic<std::uint64_t> batchCount;
+
+    // Pipeline-thread scratch, reused across batches
+    std::vector<Request> batch;
+    std::vector<std::shared_ptr<const InvestmentStrategy> > strategies;
+    std::vector<std::size_t> order;
+    std::vector<double> amounts;
+    std::vector<double> values;
+
+    std::thread worker;
+};
+
+#endif // INVESTMENT_PIPELINE_H
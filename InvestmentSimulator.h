@@ -1,39 +1,142 @@
 #ifndef INVESTMENT_SIMULATOR_H
 #define INVESTMENT_SIMULATOR_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <memory>
 #include <cmath>
 #include <stdexcept>
 #include <sstream>
+#include <cstddef>
+#include <cstdint>
+
+// Why a request was rejected. The try* functions return these instead of throwing, so a
+// rejection costs no allocation or unwinding; the throwing functions are built on them.
+enum InvestmentStatus {
+    StatusOk,
+    StatusInvalidAmount,
+    StatusInvalidDeposit,
+    StatusInvalidWithdrawal,
+    StatusNoStrategy,
+    StatusInsufficientFunds,
+    StatusStrategyFailed        // the strategy threw; reported by interfaces that cannot rethrow
+};
+
+// Static text, identical to the message of the exception the throwing API raises
+const char* statusMessage(InvestmentStatus status);
 
 class InvestmentException : public std::runtime_error {
 public:
     explicit InvestmentException(const std::string& message);
+    explicit InvestmentException(InvestmentStatus status);
+};
+
+// Out of line so the throw stays off the callers' hot paths
+[[noreturn]] void throwInvestmentStatus(InvestmentStatus status);
+
+struct InvestmentResult {
+    double value;               // meaningful only when status is StatusOk
+    InvestmentStatus status;
+
+    static InvestmentResult success(double result) { return InvestmentResult{result, StatusOk}; }
+    static InvestmentResult failure(InvestmentStatus reason) { return InvestmentResult{0.0, reason}; }
+    bool ok() const { return status == StatusOk; }
+    double valueOrThrow() const {
+        if (status != StatusOk)
+            throwInvestmentStatus(status);
+        return value;
+    }
 };
 
 class InvestmentStrategy;
 class StockInvestment;
 class BondInvestment;
+class CryptoInvestment;
 class Bank;
+class ThreadPool;
+class YieldCurve;
+
+struct MonteCarloSettings {
+    std::size_t paths;
+    std::size_t stepsPerYear;
+    double horizonYears;
+    double confidence;      // VaR confidence level, e.g. 0.95
+    std::uint64_t seed;
+
+    MonteCarloSettings(std::size_t pathCount = 100000, std::size_t steps = 12, double years = 1.0,
+                       double varConfidence = 0.95, std::uint64_t rngSeed = 42)
+        : paths(pathCount), stepsPerYear(steps), horizonYears(years),
+          confidence(varConfidence), seed(rngSeed) {}
+};
+
+struct MonteCarloResult {
+    double mean;
+    double standardDeviation;
+    double percentile5;
+    double percentile50;
+    double percentile95;
+    double valueAtRisk;     // principal minus the (1 - confidence) quantile; positive means a loss
+};
 
+// Shared by the strategy simulators: argument checks, and the statistics of the terminal values
+// (reorders terminal while selecting quantiles)
+void validateSimulation(double amount, const MonteCarloSettings& settings);
+MonteCarloResult summarizeTerminalValues(std::vector<double>& terminal, double amount, double confidence);
+
+
+// A parameter hash in two independently mixed halves. Caches index on key and confirm a hit with
+// check, so returning another configuration's results takes a collision in both.
+struct ParameterFingerprint {
+    std::uint64_t key;
+    std::uint64_t check;
+};
 
 class InvestmentStrategy {
 protected:
     std::string strategyName;
     double riskRating;
+    ParameterFingerprint parameterFingerprint;
 public:
     InvestmentStrategy(const std::string& name, double risk);
     virtual ~InvestmentStrategy();
     
+    // Non-throwing evaluation; overrides reject non-positive amounts with StatusInvalidAmount
+    virtual InvestmentResult tryInvest(double amount) const;
+    virtual InvestmentResult tryCalculatePotentialReturn(double amount) const;
+    // Throw InvestmentException where the try* forms report a status. A subclass may override
+    // either form: the defaults delegate to each other, so Bank's tryInvest path still reaches an
+    // overridden invest() and invest() still reaches an overridden tryInvest()
     virtual double invest(double amount) const;
     virtual double calculatePotentialReturn(double amount) const;
     virtual double calculateRisk() const;
+
+    // Evaluates tryInvest() for n contiguous amounts, throwing on the first failure. The built-in
+    // strategies validate once and run a specialized loop unless a subclass may have overridden invest()
+    virtual void investBatch(const double* amounts, double* out, std::size_t n) const;
     
     virtual std::string getStrategyName() const;
     virtual double getRiskRating() const;
     virtual void setRiskRating(double risk);
     virtual std::string getInvestmentDetails(double amount) const;
+    // Appends the same text as getInvestmentDetails without allocating beyond out's capacity
+    virtual void appendInvestmentDetails(std::string& out, double amount) const;
+
+    // Hash of the strategy type and every parameter that affects its results. Constructors and
+    // setters refresh it, so caches keyed on it never see stale values.
+    std::uint64_t getParameterFingerprint() const;
+    // Second hash of the same inputs, independent of the fingerprint
+    std::uint64_t getParameterCheck() const;
+
+protected:
+    static void validateBatch(const double* amounts, const double* out, std::size_t n);
+
+    // Overrides mix their parameters into the base hash; derived constructors and setters
+    // call updateFingerprint() once their fields are set
+    virtual ParameterFingerprint computeFingerprint() const;
+    static ParameterFingerprint mixFingerprint(const ParameterFingerprint& hash, double value);
+    void updateFingerprint();
 };
 
 class StockInvestment : public InvestmentStrategy {
@@ -43,15 +146,24 @@ private:
     double dividendYield;
 public:
     StockInvestment(double risk = 0.5, double returnRate = 0.12, double volatility = 0.2, double divYield = 0.03);
-    double invest(double amount) const override;
-    double calculatePotentialReturn(double amount) const override;
+    InvestmentResult tryInvest(double amount) const override;
+    InvestmentResult tryCalculatePotentialReturn(double amount) const override;
     double calculateRisk() const override;
+    void investBatch(const double* amounts, double* out, std::size_t n) const override;
+
+    // GBM paths driven by expectedReturn + dividendYield (drift) and volatilityFactor (sigma)
+    MonteCarloResult simulate(double amount, const MonteCarloSettings& settings = MonteCarloSettings()) const;
+    MonteCarloResult simulate(double amount, const MonteCarloSettings& settings, ThreadPool& pool) const;
+
     double getExpectedReturn() const;
     void setExpectedReturn(double returnRate);
     double getVolatilityFactor() const;
     void setVolatilityFactor(double volatility);
     double getDividendYield() const;
     void setDividendYield(double divYield);
+
+protected:
+    ParameterFingerprint computeFingerprint() const override;
 };
 
 class BondInvestment : public InvestmentStrategy {
@@ -66,13 +178,35 @@ private:
     double baseRiskWeight;
     double inflationAdjustment;
 
+    // Derived from the fields above; refreshed by the constructor and every setter
+    double cachedEffectiveRate;
+    double cachedGrowthFactor;
+    void updateCachedRates();
+    // Fingerprint of everything but the interest rate, kept by computeFingerprint
+    mutable ParameterFingerprint termsFingerprint;
+
+    // When set, the curve supplies interestRate and the cached rates, and refreshes them on updates
+    std::shared_ptr<YieldCurve> yieldCurve;
+    friend class YieldCurve;
+
 public:
     BondInvestment(double rate = 0.05, int years = 5, double inflation = 0.02, bool isCallable = false,
                    double callableAdj = 0.9, double riskWeight = 0.8, double inflationAdj = 1.0);
+    // Copies attach to the same curve
+    BondInvestment(const BondInvestment& other);
+    BondInvestment& operator=(const BondInvestment& other);
+    ~BondInvestment() override;
 
-    double invest(double amount) const override;
-    double calculatePotentialReturn(double amount) const override;
+    InvestmentResult tryInvest(double amount) const override;
+    InvestmentResult tryCalculatePotentialReturn(double amount) const override;
     double calculateRisk() const override;
+    void investBatch(const double* amounts, double* out, std::size_t n) const override;
+
+    static double integerPower(double base, int exponent);
+    // Growth factor (1 + effective rate)^year for year = 1..maxYears, at index year - 1
+    std::vector<double> growthTable(int maxYears) const;
+    double getEffectiveRate() const;
+    double getGrowthFactor() const;
 
     double getInterestRate() const;
     void setInterestRate(double rate);
@@ -82,6 +216,15 @@ public:
     void setInflationRate(double inflation);
     bool isCallable() const;
     void setCallable(bool isCallable);
+    // Validates and applies all four at once, refreshing the cached rates a single time
+    void setTerms(double rate, int years, double inflation, bool isCallable);
+
+    // Prices the bond off the curve's zero rate for its term instead of a flat rate; the term must
+    // be within the curve horizon. getInterestRate then reports the curve rate, and setting the
+    // rate throws until the bond is detached with nullptr, which keeps the last curve rate.
+    // Portfolios, position files, journals and snapshots record that rate as a flat rate.
+    void setYieldCurve(std::shared_ptr<YieldCurve> curve);
+    std::shared_ptr<YieldCurve> getYieldCurve() const;
 
     // Getters and setters for new variables
     double getCallableAdjustment() const;
@@ -91,21 +234,108 @@ public:
     double getInflationAdjustment() const;
     void setInflationAdjustment(double adj);
 
-    std::string getInvestmentDetails(double amount) const override;
+    void appendInvestmentDetails(std::string& out, double amount) const override;
+
+protected:
+    ParameterFingerprint computeFingerprint() const override;
+};
+
+// Merton jump-diffusion: lognormal diffusion plus Poisson-arriving lognormal jumps, which gives
+// the fat tails seen in crypto returns. The hype factor sets the expected growth rate.
+class CryptoInvestment : public InvestmentStrategy {
+private:
+    std::string cryptoName;
+    double cryptoVolatility;
+    double hypeFactor;
+    double jumpIntensity;       // expected jumps per year
+    double jumpMean;            // mean log jump size
+    double jumpVolatility;      // standard deviation of the log jump size
+public:
+    CryptoInvestment(const std::string& name = "Bitcoin", double volatility = 0.8, double hype = 1.0,
+                     double jumpRate = 1.0, double jumpMeanSize = -0.05, double jumpVol = 0.2);
+
+    // Expected one-year value; the jump compensator keeps the simulated mean equal to it
+    InvestmentResult tryInvest(double amount) const override;
+    InvestmentResult tryCalculatePotentialReturn(double amount) const override;
+    double calculateRisk() const override;
+    void investBatch(const double* amounts, double* out, std::size_t n) const override;
+
+    // Continuously compounded expected growth rate
+    double getDriftRate() const;
+
+    // Terminal values of paths firstPath .. firstPath + n - 1; each depends only on (seed, path),
+    // so any split of a run into batches gives the same values. Sampled exactly at the horizon.
+    // Throws if jumpIntensity * horizonYears exceeds about 360 expected jumps.
+    void sampleTerminalValues(double amount, double horizonYears, std::uint64_t seed, std::uint64_t firstPath,
+                              double* out, std::size_t n) const;
+    // settings.stepsPerYear is unused: the model is sampled exactly at the horizon
+    MonteCarloResult simulate(double amount, const MonteCarloSettings& settings = MonteCarloSettings()) const;
+    MonteCarloResult simulate(double amount, const MonteCarloSettings& settings, ThreadPool& pool) const;
+
+    std::string getCryptoName() const;
+    void setCryptoName(const std::string& name);
+    double getCryptoVolatility() const;
+    void setCryptoVolatility(double volatility);
+    double getHypeFactor() const;
+    void setHypeFactor(double hype);
+    double getJumpIntensity() const;
+    void setJumpIntensity(double jumpRate);
+    double getJumpMean() const;
+    void setJumpMean(double jumpMeanSize);
+    double getJumpVolatility() const;
+    void setJumpVolatility(double jumpVol);
+
+    void appendInvestmentDetails(std::string& out, double amount) const override;
+
+protected:
+    ParameterFingerprint computeFingerprint() const override;
 };
 
 
 
+enum BankOperationType : std::uint8_t {
+    OperationDeposit = 0,
+    OperationWithdrawal = 1,
+    OperationInvestment = 2
+};
+
+// One instruction for Bank::applyOperations; bank indexes the banks array
+struct BankOperation {
+    std::uint32_t bank;
+    std::uint8_t type;
+    double amount;
+};
+
+// Funds and strategy operations are safe to call from multiple threads; the name is not
+// synchronized and should be set before the bank is shared.
 class Bank {
 private:
-    std::shared_ptr<InvestmentStrategy> strategy;
+    std::shared_ptr<InvestmentStrategy> strategy;   // accessed only through std::atomic_load/store
+    std::atomic<const InvestmentStrategy*> borrowedStrategy;    // takes precedence when set
+    mutable std::mutex strategyMutex;   // serializes the setters so one of the two pointers stays set
     std::string name;
-    double availableFunds;
+    std::atomic<double> availableFunds;
+
+    bool reserveFunds(double amount);
+    void releaseFunds(double amount);
+    InvestmentResult investWith(const InvestmentStrategy& current, double amount);
 public:
     Bank(const std::string& bankName, double initialFunds = 0.0);
+    // Starts with a strategy already set, without the synchronization setStrategy needs
+    Bank(const std::string& bankName, double initialFunds, std::shared_ptr<InvestmentStrategy> initialStrategy);
+    Bank(const Bank& other);
+    Bank& operator=(const Bank& other);
     
     void setStrategy(std::shared_ptr<InvestmentStrategy> newStrategy);
+    // Uses a strategy the bank does not own, e.g. one from a StrategyArena, with no reference
+    // counting per investment. It must outlive every investment started before it is replaced.
+    void setBorrowedStrategy(const InvestmentStrategy* newStrategy);
+    // The strategy executeInvestment would use now, or null. An owned strategy is kept alive by
+    // the returned pointer; a borrowed one is returned without ownership.
+    std::shared_ptr<const InvestmentStrategy> getStrategy() const;
     double executeInvestment(double amount);
+    // Leaves the funds untouched on any status other than StatusOk
+    InvestmentResult tryExecuteInvestment(double amount);
     
     std::string getCurrentStrategyName() const;
     std::string getName() const;
@@ -114,8 +344,23 @@ public:
     double getAvailableFunds() const;
     void depositFunds(double amount);
     bool withdrawFunds(double amount);
+    InvestmentStatus tryDepositFunds(double amount);
+    // StatusInsufficientFunds where withdrawFunds returns false
+    InvestmentStatus tryWithdrawFunds(double amount);
     
     std::string getDetails() const;
+    void appendDetails(std::string& out) const;
+
+    // Applies operations in order with the same checks and statuses as the try* calls, writing
+    // each status and value: the result for a successful investment, otherwise the balance after
+    // the operation. The funds checks are branch-free selects; accepted investments are valued
+    // after each block of operations, with one investBatch call per strategy. A strategy that
+    // throws fails its items with StatusStrategyFailed and their funds are returned at the end of
+    // that block, before the next block's funds checks.
+    // The banks must not be used by other threads during the call. Returns the number of
+    // operations with StatusOk.
+    static std::size_t applyOperations(Bank* banks, std::size_t bankCount, const BankOperation* operations,
+                                       std::size_t count, InvestmentStatus* statuses, double* values);
 };
 
 
@@ -1,8 +1,13 @@
 #include "InvestmentSimulator.h"
-#include <sstream>
+#include "DetailFormat.h"
+#include "CounterRng.h"
+#include <cstring>
+#include <functional>
 
 InvestmentStrategy::InvestmentStrategy(const std::string& name, double risk)
-    : strategyName(name), riskRating(risk) {}
+    : strategyName(name), riskRating(risk) {
+    parameterFingerprint = InvestmentStrategy::computeFingerprint();
+}
 
 InvestmentStrategy::~InvestmentStrategy() {}
 
@@ -19,27 +24,122 @@ void InvestmentStrategy::setRiskRating(double risk) {
         riskRating = risk;
     else
         throw InvestmentException("Risk rating must be between 0.0 and 1.0");
+    updateFingerprint();
+}
+
+std::uint64_t InvestmentStrategy::getParameterFingerprint() const {
+    return parameterFingerprint.key;
+}
+
+std::uint64_t InvestmentStrategy::getParameterCheck() const {
+    return parameterFingerprint.check;
+}
+
+// The check half starts from FNV-1a of the name rather than std::hash, so a name collision in one
+// half does not carry over to the other
+ParameterFingerprint InvestmentStrategy::computeFingerprint() const {
+    ParameterFingerprint hash;
+    hash.key = std::hash<std::string>()(strategyName);
+    hash.check = 0xCBF29CE484222325ULL;
+    for (std::size_t i = 0; i < strategyName.size(); ++i)
+        hash.check = (hash.check ^ static_cast<unsigned char>(strategyName[i])) * 0x100000001B3ULL;
+    return mixFingerprint(hash, riskRating);
+}
+
+ParameterFingerprint InvestmentStrategy::mixFingerprint(const ParameterFingerprint& hash, double value) {
+    std::uint64_t bits = 0;
+    if (value != 0.0)       // +0.0 and -0.0 hash alike
+        std::memcpy(&bits, &value, sizeof(bits));
+    ParameterFingerprint mixed;
+    mixed.key = CounterRng::mix(hash.key * 0x9E3779B97F4A7C15ULL + bits);
+    mixed.check = CounterRng::mix((hash.check ^ bits) * 0xC2B2AE3D27D4EB4FULL + 0x165667B19E3779F9ULL);
+    return mixed;
+}
+
+void InvestmentStrategy::updateFingerprint() {
+    parameterFingerprint = computeFingerprint();
 }
 
 std::string InvestmentStrategy::getInvestmentDetails(double amount) const {
-    std::stringstream ss;
-    ss << "Investing $" << amount << " using " << strategyName 
-       << " strategy (Risk rating: " << riskRating << ")";
-    return ss.str();
+    std::string details;
+    details.reserve(256);
+    appendInvestmentDetails(details, amount);
+    return details;
+}
+
+void InvestmentStrategy::appendInvestmentDetails(std::string& out, double amount) const {
+    out += "Investing $";
+    appendNumber(out, amount);
+    out += " using ";
+    out += strategyName;
+    out += " strategy (Risk rating: ";
+    appendNumber(out, riskRating);
+    out += ")";
+}
+
+namespace {
+// The strategy whose default try* form is waiting on its throwing form on this thread. When the
+// throwing form comes back to the default try* form on the same object, neither was overridden
+// and the base valuation ends the cycle.
+thread_local const InvestmentStrategy* delegatingInvest = nullptr;
+thread_local const InvestmentStrategy* delegatingReturn = nullptr;
+
+class DelegationGuard {
+public:
+    DelegationGuard(const InvestmentStrategy*& slot, const InvestmentStrategy* strategy)
+        : slot(slot), previous(slot) { slot = strategy; }
+    ~DelegationGuard() { slot = previous; }
+private:
+    const InvestmentStrategy*& slot;
+    const InvestmentStrategy* previous;
+};
+}
+
+InvestmentResult InvestmentStrategy::tryInvest(double amount) const {
+    if(!(amount > 0))
+        return InvestmentResult::failure(StatusInvalidAmount);
+    if (delegatingInvest == this)
+        return InvestmentResult::success(amount);
+    DelegationGuard guard(delegatingInvest, this);
+    return InvestmentResult::success(invest(amount));
+}
+
+InvestmentResult InvestmentStrategy::tryCalculatePotentialReturn(double amount) const {
+    if(!(amount > 0))
+        return InvestmentResult::failure(StatusInvalidAmount);
+    if (delegatingReturn == this)
+        return InvestmentResult::success(0.0);
+    DelegationGuard guard(delegatingReturn, this);
+    return InvestmentResult::success(calculatePotentialReturn(amount));
 }
 
 double InvestmentStrategy::invest(double amount) const {
-    if(amount <= 0)
-        throw InvestmentException("Investment amount must be positive");
-    return amount;
+    return tryInvest(amount).valueOrThrow();
 }
 
 double InvestmentStrategy::calculatePotentialReturn(double amount) const {
-    if(amount <= 0)
-        throw InvestmentException("Investment amount must be positive");
-    return 0.0;
+    return tryCalculatePotentialReturn(amount).valueOrThrow();
 }
 
 double InvestmentStrategy::calculateRisk() const {
     return riskRating;
 }
+
+void InvestmentStrategy::validateBatch(const double* amounts, const double* out, std::size_t n) {
+    if (n == 0)
+        return;
+    if (!amounts || !out)
+        throw InvestmentException("Batch buffers cannot be null");
+    // Branch-free scan so the compiler can vectorize the check
+    bool invalid = false;
+    for (std::size_t i = 0; i < n; ++i)
+        invalid |= !(amounts[i] > 0);
+    if (invalid)
+        throw InvestmentException("Investment amount must be positive");
+}
+
+void InvestmentStrategy::investBatch(const double* amounts, double* out, std::size_t n) const {
+    validateBatch(amounts, out, n);
+    for (std::size_t i = 0; i < n; ++i)
+        out[i] = tryInvest(amounts[i]).valueOrThrow();
+}
@@ -0,0 +1,396 @@
+#include "JournaledBank.h"
+#include "DurableFile.h"
+#include "MappedFile.h"
+#include "StrategyRecord.h"
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+const char journalMagic[8] = {'I', 'N', 'V', 'J', 'R', 'N', '0', '1'};
+const char snapshotMagic[8] = {'I', 'N', 'V', 'S', 'N', 'P', '0', '1'};
+const std::uint32_t journalVersion = 1;
+
+bool fileExists(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file)
+        return false;
+    std::fclose(file);
+    return true;
+}
+
+std::uint32_t crc32(const unsigned char* data, std::size_t size, std::uint32_t crc = 0) {
+    static const struct Table {
+        std::uint32_t entries[256];
+        Table() {
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t c = i;
+                for (int bit = 0; bit < 8; ++bit)
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                entries[i] = c;
+            }
+        }
+    } table;
+    crc = ~crc;
+    for (std::size_t i = 0; i < size; ++i)
+        crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+JournalStrategy encodeStrategy(const InvestmentStrategy& strategy, std::string& name) {
+    JournalStrategy record;
+    std::memset(&record, 0, sizeof(record));
+    encodeStrategyRecord(strategy, record, name);
+    if (name.size() > 0xFFFF - sizeof(JournalRecordHeader) - sizeof(JournalStrategy))
+        throw InvestmentException("Strategy name is too long to journal");
+    record.nameLength = static_cast<std::uint16_t>(name.size());
+    return record;
+}
+
+std::shared_ptr<InvestmentStrategy> decodeStrategy(const JournalStrategy& record, const char* nameBytes) {
+    return decodeStrategyRecord(record, std::string(nameBytes, record.nameLength));
+}
+
+JournalFileHeader makeJournalHeader() {
+    JournalFileHeader header;
+    std::memcpy(header.magic, journalMagic, sizeof(header.magic));
+    header.version = journalVersion;
+    header.reserved = 0;
+    return header;
+}
+
+} // namespace
+
+JournaledBank::JournaledBank(const std::string& journalFile, const std::string& snapshotFile,
+                             const std::string& bankName, double initialFunds, const JournalOptions& journalOptions)
+    : journalPath(journalFile), snapshotPath(snapshotFile), options(journalOptions), bank(bankName),
+      fd(-1), pendingRecords(0), sequence(0), durable(0), recovered(0), commitCount(0),
+      durableBytes(sizeof(JournalFileHeader)), committing(false), failed(false) {
+    if (options.commitEvery == 0)
+        options.commitEvery = 1;
+    try {
+        recover(bankName, initialFunds);
+    } catch (...) {
+        if (fd >= 0)
+            closeFile(fd);
+        throw;
+    }
+}
+
+JournaledBank::~JournaledBank() {
+    try {
+        sync();
+    } catch (...) {
+    }
+    if (fd >= 0)
+        closeFile(fd);
+}
+
+void JournaledBank::recover(const std::string& bankName, double initialFunds) {
+    const bool haveSnapshot = fileExists(snapshotPath);
+    if (haveSnapshot) {
+        MappedFile file(snapshotPath);
+        const unsigned char* bytes = file.data();
+        JournalSnapshotHeader header;
+        if (file.size() < sizeof(header))
+            throw InvestmentException("Snapshot file is truncated: " + snapshotPath);
+        std::memcpy(&header, bytes, sizeof(header));
+        if (std::memcmp(header.magic, snapshotMagic, sizeof(header.magic)) != 0)
+            throw InvestmentException("Not a snapshot file: " + snapshotPath);
+        if (header.version != journalVersion)
+            throw InvestmentException("Unsupported snapshot version: " + snapshotPath);
+        std::size_t offset = sizeof(header);
+        JournalStrategy saved;
+        if (header.hasStrategy) {
+            if (file.size() < offset + sizeof(saved))
+                throw InvestmentException("Snapshot file is truncated: " + snapshotPath);
+            std::memcpy(&saved, bytes + offset, sizeof(saved));
+            offset += sizeof(saved) + saved.nameLength;
+        }
+        if (file.size() != offset + header.bankNameLength ||
+            crc32(bytes + sizeof(header), file.size() - sizeof(header)) != header.checksum)
+            throw InvestmentException("Snapshot file is corrupt: " + snapshotPath);
+        bank = Bank(std::string(reinterpret_cast<const char*>(bytes) + offset, header.bankNameLength),
+                    header.availableFunds);
+        if (header.hasStrategy) {
+            strategy = decodeStrategy(saved, reinterpret_cast<const char*>(bytes) + sizeof(header) + sizeof(saved));
+            bank.setStrategy(strategy);
+        }
+        sequence = header.sequence;
+    } else {
+        bank = Bank(bankName, initialFunds);
+    }
+
+    // Replay the records after the snapshot, stopping at the first torn, corrupt or out-of-order one
+    std::size_t validEnd = 0;
+    if (fileExists(journalPath)) {
+        MappedFile file(journalPath);
+        const unsigned char* bytes = file.data();
+        if (file.size() >= sizeof(JournalFileHeader)) {
+            JournalFileHeader header;
+            std::memcpy(&header, bytes, sizeof(header));
+            if (std::memcmp(header.magic, journalMagic, sizeof(header.magic)) != 0)
+                throw InvestmentException("Not a journal file: " + journalPath);
+            if (header.version != journalVersion)
+                throw InvestmentException("Unsupported journal version: " + journalPath);
+            validEnd = sizeof(header);
+            file.adviseSequential();
+            while (file.size() - validEnd >= sizeof(JournalRecordHeader)) {
+                JournalRecordHeader record;
+                std::memcpy(&record, bytes + validEnd, sizeof(record));
+                if (record.size < sizeof(record) || record.size > file.size() - validEnd ||
+                    crc32(bytes + validEnd + sizeof(record.checksum), record.size - sizeof(record.checksum)) != record.checksum)
+                    break;
+                if (record.sequence > sequence) {
+                    if (record.sequence != sequence + 1)
+                        break;
+                    replay(record, bytes + validEnd + sizeof(record));
+                    sequence = record.sequence;
+                    ++recovered;
+                }
+                validEnd += record.size;
+            }
+        }
+    }
+
+    fd = openFile(journalPath, false);
+    if (fd < 0)
+        throw InvestmentException("Cannot open journal: " + journalPath);
+    if (validEnd == 0) {
+        JournalFileHeader header = makeJournalHeader();
+        if (!truncateFile(fd, 0) || !writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)))
+            throw InvestmentException("Cannot write journal: " + journalPath);
+    } else if (!truncateFile(fd, validEnd)) {
+        throw InvestmentException("Cannot truncate journal: " + journalPath);
+    } else {
+        durableBytes = validEnd;
+    }
+    if (!syncFile(fd))
+        throw InvestmentException("Cannot sync journal: " + journalPath);
+    durable = sequence;
+    if (!haveSnapshot)
+        writeSnapshot();
+}
+
+void JournaledBank::replay(const JournalRecordHeader& header, const unsigned char* payload) {
+    const std::size_t payloadSize = header.size - sizeof(header);
+    double amount = 0.0;
+    if (header.type != JournalStrategyChange) {
+        if (payloadSize < sizeof(amount))
+            throw InvestmentException("Journal record is malformed: " + journalPath);
+        std::memcpy(&amount, payload, sizeof(amount));
+    }
+    switch (header.type) {
+    case JournalDeposit:
+        bank.depositFunds(amount);
+        break;
+    case JournalWithdrawal:
+    case JournalInvestment:
+        // Investments only moved funds out of the bank; their results are kept for auditing
+        if (!bank.withdrawFunds(amount))
+            throw InvestmentException("Journal replay overdraws the bank: " + journalPath);
+        break;
+    case JournalStrategyChange: {
+        JournalStrategy saved;
+        if (payloadSize < sizeof(saved))
+            throw InvestmentException("Journal record is malformed: " + journalPath);
+        std::memcpy(&saved, payload, sizeof(saved));
+        if (payloadSize != sizeof(saved) + saved.nameLength)
+            throw InvestmentException("Journal record is malformed: " + journalPath);
+        strategy = decodeStrategy(saved, reinterpret_cast<const char*>(payload) + sizeof(saved));
+        bank.setStrategy(strategy);
+        break;
+    }
+    default:
+        throw InvestmentException("Unknown journal record type: " + journalPath);
+    }
+}
+
+void JournaledBank::append(JournalRecordType type, const void* payload, std::size_t payloadSize,
+                           const std::string& name, std::unique_lock<std::mutex>& lock) {
+    JournalRecordHeader header;
+    header.checksum = 0;
+    header.size = static_cast<std::uint16_t>(sizeof(header) + payloadSize + name.size());
+    header.type = type;
+    header.reserved = 0;
+    header.sequence = sequence + 1;
+
+    const std::size_t start = pending.size();
+    pending.append(reinterpret_cast<const char*>(&header), sizeof(header));
+    pending.append(static_cast<const char*>(payload), payloadSize);
+    pending.append(name);
+    const unsigned char* record = reinterpret_cast<const unsigned char*>(pending.data()) + start;
+    header.checksum = crc32(record + sizeof(header.checksum), header.size - sizeof(header.checksum));
+    std::memcpy(&pending[start], &header.checksum, sizeof(header.checksum));
+
+    const std::uint64_t appended = ++sequence;
+    if (options.waitForDurability || ++pendingRecords >= options.commitEvery)
+        commitThrough(appended, lock);
+}
+
+// Group commit: the first waiter writes and syncs everything pending, outside the lock, while
+// later operations queue up behind it for the next commit
+void JournaledBank::commitThrough(std::uint64_t target, std::unique_lock<std::mutex>& lock) {
+    while (durable < target) {
+        throwIfFailed();
+        if (committing) {
+            committed.wait(lock);
+            continue;
+        }
+        committing = true;
+        // The two buffers trade places, so steady-state commits allocate nothing
+        writing.clear();
+        writing.swap(pending);
+        pendingRecords = 0;
+        const std::uint64_t through = sequence;
+        lock.unlock();
+        bool ok = writeAll(fd, writing.data(), writing.size()) && syncFile(fd);
+        lock.lock();
+        committing = false;
+        if (ok) {
+            durable = through;
+            durableBytes += writing.size();
+            ++commitCount;
+        } else {
+            // The failed batch is already applied to the bank and may have left a torn record.
+            // Appending past it would leave a sequence gap that recovery stops at, silently
+            // dropping later durable records, so cut the file back and stop taking operations.
+            failed = true;
+            truncateFile(fd, durableBytes);
+        }
+        committed.notify_all();
+        if (!ok)
+            throw InvestmentException("Cannot write journal: " + journalPath);
+    }
+}
+
+void JournaledBank::throwIfFailed() const {
+    if (failed)
+        throw InvestmentException("Journal is unusable after a failed write: " + journalPath);
+}
+
+void JournaledBank::writeSnapshot() {
+    JournalSnapshotHeader header;
+    std::memcpy(header.magic, snapshotMagic, sizeof(header.magic));
+    header.version = journalVersion;
+    header.sequence = sequence;
+    header.availableFunds = bank.getAvailableFunds();
+    const std::string name = bank.getName();
+    header.bankNameLength = static_cast<std::uint32_t>(name.size());
+    header.hasStrategy = strategy ? 1 : 0;
+
+    std::string body;
+    if (strategy) {
+        std::string strategyName;
+        JournalStrategy saved = encodeStrategy(*strategy, strategyName);
+        body.append(reinterpret_cast<const char*>(&saved), sizeof(saved));
+        body.append(strategyName);
+    }
+    body.append(name);
+    header.checksum = crc32(reinterpret_cast<const unsigned char*>(body.data()), body.size());
+
+    const std::string temporary = snapshotPath + ".tmp";
+    int out = openFile(temporary, true);
+    if (out < 0)
+        throw InvestmentException("Cannot create snapshot: " + temporary);
+    bool ok = writeAll(out, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+              writeAll(out, body.data(), body.size()) && syncFile(out);
+    closeFile(out);
+    if (!ok || !replaceFile(temporary, snapshotPath))
+        throw InvestmentException("Cannot write snapshot: " + snapshotPath);
+}
+
+void JournaledBank::setStrategy(std::shared_ptr<InvestmentStrategy> newStrategy) {
+    if (!newStrategy)
+        throw InvestmentException("Strategy cannot be null");
+    std::string name;
+    JournalStrategy saved = encodeStrategy(*newStrategy, name);
+    std::unique_lock<std::mutex> lock(mutex);
+    throwIfFailed();
+    bank.setStrategy(newStrategy);
+    strategy = newStrategy;
+    append(JournalStrategyChange, &saved, sizeof(saved), name, lock);
+}
+
+double JournaledBank::executeInvestment(double amount) {
+    std::unique_lock<std::mutex> lock(mutex);
+    throwIfFailed();
+    double payload[2];
+    payload[0] = amount;
+    payload[1] = bank.executeInvestment(amount);
+    append(JournalInvestment, payload, sizeof(payload), std::string(), lock);
+    return payload[1];
+}
+
+void JournaledBank::depositFunds(double amount) {
+    std::unique_lock<std::mutex> lock(mutex);
+    throwIfFailed();
+    bank.depositFunds(amount);
+    append(JournalDeposit, &amount, sizeof(amount), std::string(), lock);
+}
+
+bool JournaledBank::withdrawFunds(double amount) {
+    std::unique_lock<std::mutex> lock(mutex);
+    throwIfFailed();
+    if (!bank.withdrawFunds(amount))
+        return false;
+    append(JournalWithdrawal, &amount, sizeof(amount), std::string(), lock);
+    return true;
+}
+
+double JournaledBank::getAvailableFunds() const {
+    return bank.getAvailableFunds();
+}
+
+std::string JournaledBank::getCurrentStrategyName() const {
+    return bank.getCurrentStrategyName();
+}
+
+std::string JournaledBank::getName() const {
+    return bank.getName();
+}
+
+void JournaledBank::sync() {
+    std::unique_lock<std::mutex> lock(mutex);
+    throwIfFailed();
+    commitThrough(sequence, lock);
+}
+
+// Records up to the snapshot are skipped on recovery, so a crash between writing the snapshot and
+// emptying the journal loses nothing
+void JournaledBank::checkpoint() {
+    std::unique_lock<std::mutex> lock(mutex);
+    throwIfFailed();
+    while (committing || durable < sequence) {
+        if (committing)
+            committed.wait(lock);
+        else
+            commitThrough(sequence, lock);
+    }
+    writeSnapshot();
+    if (!truncateFile(fd, sizeof(JournalFileHeader)))
+        throw InvestmentException("Cannot truncate journal: " + journalPath);
+    durableBytes = sizeof(JournalFileHeader);
+    if (!syncFile(fd))
+        throw InvestmentException("Cannot truncate journal: " + journalPath);
+}
+
+std::uint64_t JournaledBank::lastSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sequence;
+}
+
+std::uint64_t JournaledBank::durableSequence() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return durable;
+}
+
+std::uint64_t JournaledBank::recoveredRecords() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return recovered;
+}
+
+std::uint64_t JournaledBank::commits() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return commitCount;
+}
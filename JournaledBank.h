@@ -0,0 +1,145 @@
+#ifndef JOURNALED_BANK_H
+#define JOURNALED_BANK_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "InvestmentSimulator.h"
+
+// Write-ahead journal file: a 16-byte JournalFileHeader followed by variable-length records, each
+// a JournalRecordHeader and its payload, in host (little-endian) byte order. Payloads:
+//   deposit, withdrawal:  double amount
+//   investment:           double amount, double result
+//   strategy change:      JournalStrategy followed by nameLength name bytes
+// Snapshot file: a JournalSnapshotHeader, then (if hasStrategy) a JournalStrategy and its name,
+// then the bank name.
+
+enum JournalRecordType : std::uint8_t {
+    JournalDeposit = 1,
+    JournalWithdrawal = 2,
+    JournalInvestment = 3,
+    JournalStrategyChange = 4
+};
+
+struct JournalFileHeader {
+    char magic[8];              // "INVJRN01"
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct JournalRecordHeader {
+    std::uint32_t checksum;     // CRC-32 of the rest of the record
+    std::uint16_t size;         // whole record, this header included
+    std::uint8_t type;
+    std::uint8_t reserved;
+    std::uint64_t sequence;     // consecutive from 1; snapshots record the last one they include
+};
+
+// Strategy fields as StrategyRecord.h encodes them; params[5] is unused
+struct JournalStrategy {
+    std::uint8_t kind;          // StrategyRecordKind
+    std::uint8_t callable;
+    std::uint16_t nameLength;
+    std::int32_t termYears;
+    double riskRating;
+    double params[6];
+};
+
+struct JournalSnapshotHeader {
+    char magic[8];              // "INVSNP01"
+    std::uint32_t version;
+    std::uint32_t checksum;     // CRC-32 of everything after the header
+    std::uint64_t sequence;
+    double availableFunds;
+    std::uint32_t bankNameLength;
+    std::uint32_t hasStrategy;
+};
+
+static_assert(sizeof(JournalFileHeader) == 16, "JournalFileHeader layout changed");
+static_assert(sizeof(JournalRecordHeader) == 16, "JournalRecordHeader layout changed");
+static_assert(sizeof(JournalStrategy) == 64, "JournalStrategy layout changed");
+static_assert(sizeof(JournalSnapshotHeader) == 40, "JournalSnapshotHeader layout changed");
+
+struct JournalOptions {
+    // Each operation returns only once its record is on disk. Operations that arrive while a
+    // commit is in progress are written and synced together by the next one (group commit).
+    bool waitForDurability;
+    // Without waitForDurability: commit whenever this many records are pending. A crash loses at
+    // most the pending records; sync() forces them out.
+    std::size_t commitEvery;
+
+    JournalOptions(bool wait = true, std::size_t every = 1)
+        : waitForDurability(wait), commitEvery(every) {}
+};
+
+// A Bank whose deposits, withdrawals, investments and strategy changes are logged to an append-only
+// journal. Opening an existing journal recovers the bank from the last snapshot plus the records
+// after it; a torn or corrupt tail is discarded. The bank name and initial funds are used only
+// when no snapshot exists yet. Rejected operations are not logged, and neither are later changes
+// made through a strategy's own setters (call setStrategy again to record them). setStrategy
+// throws for a strategy type the journal cannot record (see StrategyRecord.h). Safe to use from
+// multiple threads; operations are applied and logged in one order. If a commit fails, the journal
+// is cut back to its last durable record and every later operation, sync or checkpoint throws;
+// reopen the bank to continue from what is on disk.
+class JournaledBank {
+public:
+    JournaledBank(const std::string& journalPath, const std::string& snapshotPath, const std::string& bankName,
+                  double initialFunds = 0.0, const JournalOptions& options = JournalOptions());
+    ~JournaledBank();
+
+    JournaledBank(const JournaledBank&) = delete;
+    JournaledBank& operator=(const JournaledBank&) = delete;
+
+    void setStrategy(std::shared_ptr<InvestmentStrategy> newStrategy);
+    double executeInvestment(double amount);
+    void depositFunds(double amount);
+    bool withdrawFunds(double amount);
+
+    double getAvailableFunds() const;
+    std::string getCurrentStrategyName() const;
+    std::string getName() const;
+
+    // Writes and syncs every pending record
+    void sync();
+    // Writes a snapshot of the current state and empties the journal
+    void checkpoint();
+
+    std::uint64_t lastSequence() const;
+    std::uint64_t durableSequence() const;
+    std::uint64_t recoveredRecords() const;
+    std::uint64_t commits() const;
+
+private:
+    void recover(const std::string& bankName, double initialFunds);
+    void replay(const JournalRecordHeader& header, const unsigned char* payload);
+    void append(JournalRecordType type, const void* payload, std::size_t payloadSize,
+                const std::string& name, std::unique_lock<std::mutex>& lock);
+    void commitThrough(std::uint64_t sequence, std::unique_lock<std::mutex>& lock);
+    void throwIfFailed() const;
+    void writeSnapshot();
+
+    std::string journalPath;
+    std::string snapshotPath;
+    JournalOptions options;
+    Bank bank;
+    std::shared_ptr<InvestmentStrategy> strategy;
+
+    mutable std::mutex mutex;
+    std::condition_variable committed;
+    int fd;
+    std::string pending;            // encoded records not yet written
+    std::string writing;            // the batch being committed; owned by the committing thread
+    std::size_t pendingRecords;
+    std::uint64_t sequence;         // last record appended
+    std::uint64_t durable;          // last record synced
+    std::uint64_t recovered;
+    std::uint64_t commitCount;
+    std::size_t durableBytes;       // journal length through the last synced record
+    bool committing;
+    bool failed;                    // a commit failed; the bank is ahead of the journal
+};
+
+#endif // JOURNALED_BANK_H
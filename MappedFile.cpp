@@ -0,0 +1,104 @@
+#include "MappedFile.h"
+#include "InvestmentSimulator.h"
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::string& path)
+    : bytes(nullptr), length(0), fileHandle(INVALID_HANDLE_VALUE), mappingHandle(nullptr) {
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        throw InvestmentException("Cannot open file: " + path);
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileHandle, &fileSize);
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    if (length == 0)
+        return;
+    mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mappingHandle)
+        bytes = static_cast<const unsigned char*>(MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (!bytes) {
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        throw InvestmentException("Cannot map file: " + path);
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (bytes)
+        UnmapViewOfFile(bytes);
+    if (mappingHandle)
+        CloseHandle(mappingHandle);
+    if (fileHandle != INVALID_HANDLE_VALUE)
+        CloseHandle(fileHandle);
+}
+
+void MappedFile::adviseSequential() const {}
+
+void MappedFile::release(std::size_t, std::size_t) const {}
+
+#else
+
+MappedFile::MappedFile(const std::string& path)
+    : bytes(nullptr), length(0) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw InvestmentException("Cannot open file: " + path);
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw InvestmentException("Cannot stat file: " + path);
+    }
+    length = static_cast<std::size_t>(info.st_size);
+    if (length > 0) {
+        void* mapped = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped == MAP_FAILED) {
+            ::close(fd);
+            throw InvestmentException("Cannot map file: " + path);
+        }
+        bytes = static_cast<const unsigned char*>(mapped);
+    }
+    ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (bytes)
+        ::munmap(const_cast<unsigned char*>(bytes), length);
+}
+
+void MappedFile::adviseSequential() const {
+    if (bytes)
+        ::madvise(const_cast<unsigned char*>(bytes), length, MADV_SEQUENTIAL);
+}
+
+void MappedFile::release(std::size_t offset, std::size_t count) const {
+    if (!bytes || offset >= length)
+        return;
+    // madvise needs a page-aligned start; only whole pages inside the range are dropped
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    std::size_t begin = (offset + page - 1) / page * page;
+    std::size_t end = std::min(length, offset + count) / page * page;
+    if (end > begin)
+        ::madvise(const_cast<unsigned char*>(bytes) + begin, end - begin, MADV_DONTNEED);
+}
+
+#endif
+
+const unsigned char* MappedFile::data() const {
+    return bytes;
+}
+
+std::size_t MappedFile::size() const {
+    return length;
+}
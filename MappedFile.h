@@ -0,0 +1,33 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const;
+    std::size_t size() const;
+
+    // Hints that [offset, offset + length) is read front to back / no longer needed,
+    // so streaming readers keep a bounded resident set. Both are advisory.
+    void adviseSequential() const;
+    void release(std::size_t offset, std::size_t length) const;
+
+private:
+    const unsigned char* bytes;
+    std::size_t length;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mappingHandle;
+#endif
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,286 @@
+#include "Metrics.h"
+#include "DetailFormat.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// Index of the highest set bit; value must be non-zero
+std::size_t highestBit(std::uint64_t value) {
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return static_cast<std::size_t>(index);
+#elif defined(__GNUC__)
+    return 63 - static_cast<std::size_t>(__builtin_clzll(value));
+#else
+    std::size_t index = 0;
+    while (value >>= 1)
+        ++index;
+    return index;
+#endif
+}
+
+struct ThreadMetrics {
+    std::atomic<std::uint64_t> counters[MetricCounterCount];
+    std::atomic<std::uint64_t> buckets[MetricHistogramCount][Metrics::BucketCount];
+    std::atomic<std::uint64_t> sums[MetricHistogramCount];
+    std::atomic<std::uint64_t> maxima[MetricHistogramCount];
+
+    ThreadMetrics() { clear(); }
+
+    void clear() {
+        for (std::size_t c = 0; c < MetricCounterCount; ++c)
+            counters[c].store(0, std::memory_order_relaxed);
+        for (std::size_t h = 0; h < MetricHistogramCount; ++h) {
+            for (std::size_t b = 0; b < Metrics::BucketCount; ++b)
+                buckets[h][b].store(0, std::memory_order_relaxed);
+            sums[h].store(0, std::memory_order_relaxed);
+            maxima[h].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // Only the owning thread writes, so a relaxed load and store is enough
+    static void add(std::atomic<std::uint64_t>& cell, std::uint64_t n) {
+        cell.store(cell.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void mergeInto(ThreadMetrics& total) const {
+        for (std::size_t c = 0; c < MetricCounterCount; ++c)
+            add(total.counters[c], counters[c].load(std::memory_order_relaxed));
+        for (std::size_t h = 0; h < MetricHistogramCount; ++h) {
+            for (std::size_t b = 0; b < Metrics::BucketCount; ++b)
+                add(total.buckets[h][b], buckets[h][b].load(std::memory_order_relaxed));
+            add(total.sums[h], sums[h].load(std::memory_order_relaxed));
+            total.maxima[h].store(std::max(total.maxima[h].load(std::memory_order_relaxed),
+                                           maxima[h].load(std::memory_order_relaxed)), std::memory_order_relaxed);
+        }
+    }
+};
+
+// Live thread blocks, plus the totals of threads that have exited
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadMetrics*> live;
+    ThreadMetrics retired;
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry();     // never destroyed: threads may exit after main
+    return *instance;
+}
+
+// Owns the calling thread's block; on thread exit the block is folded into the retired totals
+struct ThreadRegistration {
+    ThreadMetrics metrics;
+
+    ThreadRegistration() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.live.push_back(&metrics);
+    }
+    ~ThreadRegistration() {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        metrics.mergeInto(r.retired);
+        r.live.erase(std::find(r.live.begin(), r.live.end(), &metrics));
+    }
+};
+
+// Constant-initialized fast path; the registration object is only touched on first use
+thread_local ThreadMetrics* threadMetrics = nullptr;
+
+ThreadMetrics& localMetrics() {
+    if (!threadMetrics) {
+        static thread_local ThreadRegistration registration;
+        threadMetrics = &registration.metrics;
+    }
+    return *threadMetrics;
+}
+
+std::uint64_t quantile(const std::vector<std::uint64_t>& buckets, std::uint64_t count, double q) {
+    std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(count - 1)) + 1;
+    std::uint64_t seen = 0;
+    for (std::size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= rank)
+            return Metrics::bucketUpperBound(b);
+    }
+    return Metrics::bucketUpperBound(buckets.size() - 1);
+}
+
+} // namespace
+
+bool Metrics::enabled() {
+#ifdef INVESTMENT_METRICS
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::size_t Metrics::bucketIndex(std::uint64_t value) {
+    if (value < 8)
+        return static_cast<std::size_t>(value);
+    std::size_t msb = highestBit(value);
+    return (msb - 2) * 8 + static_cast<std::size_t>((value >> (msb - 3)) & 7);
+}
+
+std::uint64_t Metrics::bucketUpperBound(std::size_t index) {
+    if (index < 8)
+        return index;
+    std::size_t msb = index / 8 + 2;
+    std::uint64_t lower = static_cast<std::uint64_t>(8 + index % 8) << (msb - 3);
+    return lower + ((static_cast<std::uint64_t>(1) << (msb - 3)) - 1);
+}
+
+void Metrics::count(MetricCounter counter, std::uint64_t n) {
+    ThreadMetrics::add(localMetrics().counters[counter], n);
+}
+
+void Metrics::record(MetricHistogram histogram, std::uint64_t value) {
+    ThreadMetrics& local = localMetrics();
+    ThreadMetrics::add(local.buckets[histogram][bucketIndex(value)], 1);
+    ThreadMetrics::add(local.sums[histogram], value);
+    if (value > local.maxima[histogram].load(std::memory_order_relaxed))
+        local.maxima[histogram].store(value, std::memory_order_relaxed);
+}
+
+MetricsSnapshot Metrics::snapshot() {
+    // Too large for the stack with every histogram's buckets
+    std::unique_ptr<ThreadMetrics> total(new ThreadMetrics());
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        r.retired.mergeInto(*total);
+        for (ThreadMetrics* metrics : r.live)
+            metrics->mergeInto(*total);
+    }
+
+    MetricsSnapshot out;
+    for (std::size_t c = 0; c < MetricCounterCount; ++c)
+        out.counters.push_back(std::make_pair(std::string(counterName(static_cast<MetricCounter>(c))),
+                                              total->counters[c].load(std::memory_order_relaxed)));
+    std::vector<std::uint64_t> buckets(BucketCount);
+    for (std::size_t h = 0; h < MetricHistogramCount; ++h) {
+        HistogramSnapshot histogram;
+        histogram.count = 0;
+        for (std::size_t b = 0; b < BucketCount; ++b) {
+            buckets[b] = total->buckets[h][b].load(std::memory_order_relaxed);
+            histogram.count += buckets[b];
+        }
+        histogram.max = total->maxima[h].load(std::memory_order_relaxed);
+        if (histogram.count == 0) {
+            histogram.mean = 0.0;
+            histogram.p50 = histogram.p90 = histogram.p99 = histogram.p999 = 0;
+        } else {
+            histogram.mean = static_cast<double>(total->sums[h].load(std::memory_order_relaxed))
+                           / static_cast<double>(histogram.count);
+            histogram.p50 = std::min(quantile(buckets, histogram.count, 0.50), histogram.max);
+            histogram.p90 = std::min(quantile(buckets, histogram.count, 0.90), histogram.max);
+            histogram.p99 = std::min(quantile(buckets, histogram.count, 0.99), histogram.max);
+            histogram.p999 = std::min(quantile(buckets, histogram.count, 0.999), histogram.max);
+        }
+        out.histograms.push_back(std::make_pair(std::string(histogramName(static_cast<MetricHistogram>(h))), histogram));
+    }
+    return out;
+}
+
+// Counts recorded concurrently with a reset may survive it
+void Metrics::reset() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.retired.clear();
+    for (ThreadMetrics* metrics : r.live)
+        metrics->clear();
+}
+
+const char* Metrics::counterName(MetricCounter counter) {
+    switch (counter) {
+    case MetricBankInvestments: return "bank_investments";
+    case MetricBankDeposits: return "bank_deposits";
+    case MetricBankWithdrawals: return "bank_withdrawals";
+    case MetricWithdrawalsDeclined: return "bank_withdrawals_declined";
+    case MetricInsufficientFunds: return "insufficient_funds";
+    case MetricInvalidAmount: return "invalid_amount";
+    case MetricExceptions: return "exceptions";
+    case MetricStrategyInvestments: return "strategy_investments";
+    default: return "unknown";
+    }
+}
+
+const char* Metrics::histogramName(MetricHistogram histogram) {
+    switch (histogram) {
+    case MetricBankExecuteLatency: return "bank_execute_ns";
+    case MetricStrategyInvestLatency: return "strategy_invest_ns";
+    default: return "unknown";
+    }
+}
+
+std::string MetricsSnapshot::toText() const {
+    std::string out;
+    for (const auto& counter : counters) {
+        out += counter.first;
+        out += ' ';
+        appendInteger(out, static_cast<long long>(counter.second));
+        out += '\n';
+    }
+    for (const auto& histogram : histograms) {
+        const HistogramSnapshot& h = histogram.second;
+        out += histogram.first;
+        out += " count=";
+        appendInteger(out, static_cast<long long>(h.count));
+        out += " mean=";
+        appendNumber(out, h.mean);
+        out += " p50=";
+        appendInteger(out, static_cast<long long>(h.p50));
+        out += " p90=";
+        appendInteger(out, static_cast<long long>(h.p90));
+        out += " p99=";
+        appendInteger(out, static_cast<long long>(h.p99));
+        out += " p999=";
+        appendInteger(out, static_cast<long long>(h.p999));
+        out += " max=";
+        appendInteger(out, static_cast<long long>(h.max));
+        out += '\n';
+    }
+    return out;
+}
+
+std::string MetricsSnapshot::toJson() const {
+    std::string out = "{\"counters\": {";
+    for (std::size_t i = 0; i < counters.size(); ++i) {
+        out += i == 0 ? "\"" : ", \"";
+        out += counters[i].first;
+        out += "\": ";
+        appendInteger(out, static_cast<long long>(counters[i].second));
+    }
+    out += "}, \"histograms\": {";
+    for (std::size_t i = 0; i < histograms.size(); ++i) {
+        const HistogramSnapshot& h = histograms[i].second;
+        out += i == 0 ? "\"" : ", \"";
+        out += histograms[i].first;
+        out += "\": {\"count\": ";
+        appendInteger(out, static_cast<long long>(h.count));
+        out += ", \"mean\": ";
+        appendNumber(out, h.mean);
+        out += ", \"p50\": ";
+        appendInteger(out, static_cast<long long>(h.p50));
+        out += ", \"p90\": ";
+        appendInteger(out, static_cast<long long>(h.p90));
+        out += ", \"p99\": ";
+        appendInteger(out, static_cast<long long>(h.p99));
+        out += ", \"p999\": ";
+        appendInteger(out, static_cast<long long>(h.p999));
+        out += ", \"max\": ";
+        appendInteger(out, static_cast<long long>(h.max));
+        out += "}";
+    }
+    out += "}}";
+    return out;
+}
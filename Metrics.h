@@ -0,0 +1,102 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Hot-path metrics for Bank and the strategies. Each thread records into its own block, so
+// recording is a plain load and store with no shared cache lines; snapshot() sums the blocks of
+// live threads and of threads that have exited. The INVESTMENT_METRIC_* macros used on hot paths
+// compile to nothing unless INVESTMENT_METRICS is defined (make ... METRICS=1).
+
+enum MetricCounter {
+    MetricBankInvestments,
+    MetricBankDeposits,
+    MetricBankWithdrawals,
+    MetricWithdrawalsDeclined,
+    MetricInsufficientFunds,
+    MetricInvalidAmount,
+    MetricExceptions,
+    MetricStrategyInvestments,
+    MetricCounterCount
+};
+
+// Latencies in nanoseconds
+enum MetricHistogram {
+    MetricBankExecuteLatency,
+    MetricStrategyInvestLatency,
+    MetricHistogramCount
+};
+
+struct HistogramSnapshot {
+    std::uint64_t count;
+    double mean;
+    std::uint64_t max;
+    // Upper bounds of the buckets holding each quantile; within 12.5% of the true value
+    std::uint64_t p50;
+    std::uint64_t p90;
+    std::uint64_t p99;
+    std::uint64_t p999;
+};
+
+struct MetricsSnapshot {
+    std::vector<std::pair<std::string, std::uint64_t> > counters;
+    std::vector<std::pair<std::string, HistogramSnapshot> > histograms;
+
+    std::string toText() const;
+    std::string toJson() const;
+};
+
+class Metrics {
+public:
+    // Log-linear buckets: values below 8 are exact, above that each power of two is split
+    // into 8 sub-buckets
+    static const std::size_t BucketCount = 496;
+
+    static bool enabled();
+    static void count(MetricCounter counter, std::uint64_t n = 1);
+    static void record(MetricHistogram histogram, std::uint64_t value);
+    static MetricsSnapshot snapshot();
+    static void reset();
+
+    static std::size_t bucketIndex(std::uint64_t value);
+    static std::uint64_t bucketUpperBound(std::size_t index);
+    static const char* counterName(MetricCounter counter);
+    static const char* histogramName(MetricHistogram histogram);
+};
+
+// Records the lifetime of the enclosing scope into a histogram
+class MetricTimer {
+public:
+    explicit MetricTimer(MetricHistogram target)
+        : histogram(target), start(std::chrono::steady_clock::now()) {}
+    ~MetricTimer() {
+        std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+        Metrics::record(histogram, static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+    }
+
+    MetricTimer(const MetricTimer&) = delete;
+    MetricTimer& operator=(const MetricTimer&) = delete;
+
+private:
+    MetricHistogram histogram;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define INVESTMENT_METRIC_CONCAT_IMPL(a, b) a##b
+#define INVESTMENT_METRIC_CONCAT(a, b) INVESTMENT_METRIC_CONCAT_IMPL(a, b)
+
+#ifdef INVESTMENT_METRICS
+#define INVESTMENT_METRIC_COUNT(counter) Metrics::count(counter)
+#define INVESTMENT_METRIC_TIME(histogram) MetricTimer INVESTMENT_METRIC_CONCAT(metricTimer, __LINE__)(histogram)
+#else
+#define INVESTMENT_METRIC_COUNT(counter) ((void)0)
+#define INVESTMENT_METRIC_TIME(histogram) ((void)0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,41 @@
+#include "InvestmentSimulator.h"
+#include <algorithm>
+
+void validateSimulation(double amount, const MonteCarloSettings& settings) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    if (settings.paths == 0)
+        throw InvestmentException("Simulation needs at least one path");
+    if (settings.stepsPerYear == 0 || settings.horizonYears <= 0.0)
+        throw InvestmentException("Simulation horizon must be positive");
+    if (settings.confidence <= 0.0 || settings.confidence >= 1.0)
+        throw InvestmentException("Confidence level must be in (0, 1)");
+}
+
+MonteCarloResult summarizeTerminalValues(std::vector<double>& terminal, double amount, double confidence) {
+    if (terminal.empty())
+        throw InvestmentException("Simulation needs at least one path");
+
+    double sum = 0.0;
+    for (double value : terminal)
+        sum += value;
+    double mean = sum / static_cast<double>(terminal.size());
+    double squares = 0.0;
+    for (double value : terminal)
+        squares += (value - mean) * (value - mean);
+
+    auto quantile = [&terminal](double q) {
+        std::size_t index = static_cast<std::size_t>(q * static_cast<double>(terminal.size() - 1));
+        std::nth_element(terminal.begin(), terminal.begin() + index, terminal.end());
+        return terminal[index];
+    };
+
+    MonteCarloResult result;
+    result.mean = mean;
+    result.standardDeviation = std::sqrt(squares / static_cast<double>(terminal.size()));
+    result.percentile5 = quantile(0.05);
+    result.percentile50 = quantile(0.50);
+    result.percentile95 = quantile(0.95);
+    result.valueAtRisk = amount - quantile(1.0 - confidence);
+    return result;
+}
@@ -0,0 +1,135 @@
+#include "PeriodSimulation.h"
+
+PeriodSimulation::PeriodSimulation(Bank& targetBank, int periods)
+    : bank(targetBank), periodsPerYear(periods), period(0), positionsValue(0.0), openCount(0), processed(0) {
+    if (periods <= 0)
+        throw InvestmentException("Periods per year must be positive");
+    dueByPhase.resize(periods);
+}
+
+std::size_t PeriodSimulation::addHolding(const InvestmentStrategy& strategy, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    double growth = strategy.invest(amount) / amount;
+    return addPosition(amount, growth, 0.0, -1);
+}
+
+std::size_t PeriodSimulation::addBond(const BondInvestment& bond, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    return addPosition(amount, 1.0 + bond.getEffectiveRate(), bond.invest(amount),
+                       period + bond.getTermYears() * periodsPerYear);
+}
+
+std::size_t PeriodSimulation::addPosition(double amount, double anniversaryGrowth, double maturityValue,
+                                          int maturityPeriod) {
+    if (!bank.withdrawFunds(amount))
+        throw InvestmentException("Insufficient funds for investment");
+    Position position;
+    position.value = amount;
+    position.anniversaryGrowth = anniversaryGrowth;
+    position.maturityValue = maturityValue;
+    position.maturityPeriod = maturityPeriod;
+    position.open = true;
+    positions.push_back(position);
+    std::size_t id = positions.size() - 1;
+    dueByPhase[period % periodsPerYear].push_back(id);
+    positionsValue += amount;
+    ++openCount;
+    return id;
+}
+
+void PeriodSimulation::closePosition(std::size_t id) {
+    if (!isOpen(id))
+        throw InvestmentException("Position is not open");
+    Position& position = positions[id];
+    // Its id is dropped from the bucket on the next pass over it
+    position.open = false;
+    positionsValue -= position.value;
+    --openCount;
+    bank.depositFunds(position.value);
+}
+
+bool PeriodSimulation::applyEvent(std::size_t id) {
+    Position& position = positions[id];
+    ++processed;
+    if (period == position.maturityPeriod) {
+        positionsValue -= position.value;
+        position.value = position.maturityValue;
+        position.open = false;
+        --openCount;
+        bank.depositFunds(position.value);
+        return false;
+    }
+    double previous = position.value;
+    position.value *= position.anniversaryGrowth;
+    positionsValue += position.value - previous;
+    return true;
+}
+
+void PeriodSimulation::step() {
+    ++period;
+    // Everything in this bucket has an anniversary now; compact out closed and matured positions
+    std::vector<std::size_t>& due = dueByPhase[period % periodsPerYear];
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < due.size(); ++i) {
+        std::size_t id = due[i];
+        if (positions[id].open && applyEvent(id))
+            due[kept++] = id;
+    }
+    due.resize(kept);
+}
+
+void PeriodSimulation::advance(int periods, std::vector<ValuationSnapshot>* out, int snapshotEvery) {
+    if (periods < 0)
+        throw InvestmentException("Period count cannot be negative");
+    if (snapshotEvery <= 0)
+        throw InvestmentException("Snapshot interval must be positive");
+    if (out)
+        out->reserve(out->size() + periods / snapshotEvery);
+    for (int i = 1; i <= periods; ++i) {
+        step();
+        if (out && i % snapshotEvery == 0)
+            out->push_back(snapshot());
+    }
+}
+
+ValuationSnapshot PeriodSimulation::snapshot() const {
+    ValuationSnapshot snap;
+    snap.period = period;
+    snap.cash = bank.getAvailableFunds();
+    snap.positionsValue = positionsValue;
+    snap.totalValue = snap.cash + positionsValue;
+    snap.openPositions = openCount;
+    return snap;
+}
+
+int PeriodSimulation::currentPeriod() const {
+    return period;
+}
+
+int PeriodSimulation::getPeriodsPerYear() const {
+    return periodsPerYear;
+}
+
+std::size_t PeriodSimulation::size() const {
+    return positions.size();
+}
+
+std::size_t PeriodSimulation::openPositions() const {
+    return openCount;
+}
+
+bool PeriodSimulation::isOpen(std::size_t id) const {
+    return id < positions.size() && positions[id].open;
+}
+
+double PeriodSimulation::positionValue(std::size_t id) const {
+    if (id >= positions.size())
+        throw InvestmentException("Unknown position");
+    return positions[id].value;
+}
+
+std::size_t PeriodSimulation::eventsProcessed() const {
+    return processed;
+}
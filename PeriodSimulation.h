@@ -0,0 +1,73 @@
+#ifndef PERIOD_SIMULATION_H
+#define PERIOD_SIMULATION_H
+
+#include <cstddef>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+// Valuation of the bank and the simulation's positions at the end of a period
+struct ValuationSnapshot {
+    int period;
+    double cash;                // the bank's available funds
+    double positionsValue;      // book value of all open positions
+    double totalValue;
+    std::size_t openPositions;
+};
+
+// Advances a Bank and a set of positions period by period. Positions are carried at book value
+// and change only on their event dates: each anniversary of the purchase, and maturity for bonds.
+// Every event falls a whole number of years after the purchase, so positions are bucketed by
+// purchase period modulo periodsPerYear; a step walks one bucket, costing O(events due) rather
+// than O(positions), and running totals make snapshot() O(1). Terms are copied at purchase;
+// later setter calls on the strategy do not affect open positions.
+class PeriodSimulation {
+public:
+    PeriodSimulation(Bank& bank, int periodsPerYear = 12);
+
+    // Withdraws amount from the bank. The position grows by invest(amount) / amount on each
+    // anniversary until closed.
+    std::size_t addHolding(const InvestmentStrategy& strategy, double amount);
+    // Withdraws amount from the bank. The bond compounds at its effective rate on each anniversary
+    // and pays bond.invest(amount) into the bank at maturity.
+    std::size_t addBond(const BondInvestment& bond, double amount);
+    // Pays the position's current book value into the bank
+    void closePosition(std::size_t id);
+
+    void step();
+    // Steps `periods` times, appending a snapshot every snapshotEvery periods when out is given
+    void advance(int periods, std::vector<ValuationSnapshot>* out = nullptr, int snapshotEvery = 1);
+    ValuationSnapshot snapshot() const;
+
+    int currentPeriod() const;
+    int getPeriodsPerYear() const;
+    std::size_t size() const;
+    std::size_t openPositions() const;
+    bool isOpen(std::size_t id) const;
+    double positionValue(std::size_t id) const;
+    // Position updates performed by step(); grows with events due, not with the size of the book
+    std::size_t eventsProcessed() const;
+
+private:
+    struct Position {
+        double value;
+        double anniversaryGrowth;
+        double maturityValue;       // exact payout for bonds
+        int maturityPeriod;         // -1 when the position has no maturity
+        bool open;
+    };
+
+    std::size_t addPosition(double amount, double anniversaryGrowth, double maturityValue, int maturityPeriod);
+    // Returns false once the position has matured
+    bool applyEvent(std::size_t id);
+
+    Bank& bank;
+    int periodsPerYear;
+    int period;
+    std::vector<Position> positions;
+    std::vector<std::vector<std::size_t> > dueByPhase;     // ids of open positions, per period % periodsPerYear
+    double positionsValue;
+    std::size_t openCount;
+    std::size_t processed;
+};
+
+#endif // PERIOD_SIMULATION_H
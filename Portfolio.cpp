@@ -0,0 +1,135 @@
+#include "Portfolio.h"
+#include "StrategyFormulas.h"
+#include <cmath>
+
+Portfolio::Portfolio() {}
+
+void Portfolio::reserve(std::size_t stockPositions, std::size_t bondPositions) {
+    stocks.riskRating.reserve(stockPositions);
+    stocks.expectedReturn.reserve(stockPositions);
+    stocks.volatility.reserve(stockPositions);
+    stocks.dividendYield.reserve(stockPositions);
+    stocks.amount.reserve(stockPositions);
+
+    bonds.riskRating.reserve(bondPositions);
+    bonds.interestRate.reserve(bondPositions);
+    bonds.termYears.reserve(bondPositions);
+    bonds.inflationRate.reserve(bondPositions);
+    bonds.callable.reserve(bondPositions);
+    bonds.callableAdjustment.reserve(bondPositions);
+    bonds.baseRiskWeight.reserve(bondPositions);
+    bonds.inflationAdjustment.reserve(bondPositions);
+    bonds.amount.reserve(bondPositions);
+}
+
+std::size_t Portfolio::addStock(const StockInvestment& stock, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    stocks.riskRating.push_back(stock.getRiskRating());
+    stocks.expectedReturn.push_back(stock.getExpectedReturn());
+    stocks.volatility.push_back(stock.getVolatilityFactor());
+    stocks.dividendYield.push_back(stock.getDividendYield());
+    stocks.amount.push_back(amount);
+    return stocks.amount.size() - 1;
+}
+
+std::size_t Portfolio::addBond(const BondInvestment& bond, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    bonds.riskRating.push_back(bond.getRiskRating());
+    bonds.interestRate.push_back(bond.getInterestRate());
+    bonds.termYears.push_back(bond.getTermYears());
+    bonds.inflationRate.push_back(bond.getInflationRate());
+    bonds.callable.push_back(bond.isCallable() ? 1 : 0);
+    bonds.callableAdjustment.push_back(bond.getCallableAdjustment());
+    bonds.baseRiskWeight.push_back(bond.getBaseRiskWeight());
+    bonds.inflationAdjustment.push_back(bond.getInflationAdjustment());
+    bonds.amount.push_back(amount);
+    return bonds.amount.size() - 1;
+}
+
+std::size_t Portfolio::stockCount() const {
+    return stocks.amount.size();
+}
+
+std::size_t Portfolio::bondCount() const {
+    return bonds.amount.size();
+}
+
+std::size_t Portfolio::size() const {
+    return stockCount() + bondCount();
+}
+
+double Portfolio::stockAmount(std::size_t index) const {
+    return stocks.amount.at(index);
+}
+
+double Portfolio::bondAmount(std::size_t index) const {
+    return bonds.amount.at(index);
+}
+
+void Portfolio::clear() {
+    *this = Portfolio();
+}
+
+void Portfolio::evaluate(PortfolioValuation& out) const {
+    const std::size_t stockN = stockCount();
+    const std::size_t bondN = bondCount();
+    out.stockValues.resize(stockN);
+    out.stockReturns.resize(stockN);
+    out.stockRisks.resize(stockN);
+    out.bondValues.resize(bondN);
+    out.bondReturns.resize(bondN);
+    out.bondRisks.resize(bondN);
+
+    // Amounts were validated on insertion, so the loops carry no error branches
+    double totalValue = 0.0;
+    double totalReturn = 0.0;
+
+    const double* risk = stocks.riskRating.data();
+    const double* expected = stocks.expectedReturn.data();
+    const double* vol = stocks.volatility.data();
+    const double* div = stocks.dividendYield.data();
+    const double* stockAmount = stocks.amount.data();
+    for (std::size_t i = 0; i < stockN; ++i) {
+        const double amount = stockAmount[i];
+        const double positionRisk = stockRisk(risk[i], vol[i]);
+        const double value = stockInvestValue(amount, positionRisk, expected[i], vol[i], div[i]);
+        const double potential = amount * (expected[i] + div[i] + vol[i] * 0.05);
+        out.stockRisks[i] = positionRisk;
+        out.stockValues[i] = value;
+        out.stockReturns[i] = potential;
+        totalValue += value;
+        totalReturn += potential;
+    }
+
+    for (std::size_t i = 0; i < bondN; ++i) {
+        const double amount = bonds.amount[i];
+        const double inflation = bonds.inflationRate[i];
+        const double inflationAdj = bonds.inflationAdjustment[i];
+        const bool isCallable = bonds.callable[i] != 0;
+
+        double effectiveRate = bonds.interestRate[i];
+        if (isCallable)
+            effectiveRate *= bonds.callableAdjustment[i];
+        if (effectiveRate > inflation)
+            effectiveRate -= inflation * inflationAdj;
+
+        const double value = amount * std::pow(1.0 + effectiveRate, bonds.termYears[i]);
+        const double potential = amount * effectiveRate * bonds.termYears[i];
+        out.bondRisks[i] = bonds.baseRiskWeight[i] * bonds.riskRating[i] + (isCallable ? 0.1 : 0.0) + inflation * inflationAdj;
+        out.bondValues[i] = value;
+        out.bondReturns[i] = potential;
+        totalValue += value;
+        totalReturn += potential;
+    }
+
+    out.totalValue = totalValue;
+    out.totalReturn = totalReturn;
+}
+
+PortfolioValuation Portfolio::evaluate() const {
+    PortfolioValuation out;
+    evaluate(out);
+    return out;
+}
@@ -0,0 +1,66 @@
+#ifndef PORTFOLIO_H
+#define PORTFOLIO_H
+
+#include <cstddef>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+// Per-position results of Portfolio::evaluate, in insertion order per position type
+struct PortfolioValuation {
+    std::vector<double> stockValues;
+    std::vector<double> stockReturns;
+    std::vector<double> stockRisks;
+    std::vector<double> bondValues;
+    std::vector<double> bondReturns;
+    std::vector<double> bondRisks;
+    double totalValue;
+    double totalReturn;
+};
+
+// Book of positions stored column-wise per strategy type. Results match
+// StockInvestment / BondInvestment invest, calculatePotentialReturn and calculateRisk.
+class Portfolio {
+public:
+    Portfolio();
+
+    void reserve(std::size_t stocks, std::size_t bonds);
+    std::size_t addStock(const StockInvestment& stock, double amount);
+    std::size_t addBond(const BondInvestment& bond, double amount);
+
+    std::size_t stockCount() const;
+    std::size_t bondCount() const;
+    std::size_t size() const;
+    double stockAmount(std::size_t index) const;
+    double bondAmount(std::size_t index) const;
+    void clear();
+
+    // Single pass over every column; out is resized and reused between calls
+    void evaluate(PortfolioValuation& out) const;
+    PortfolioValuation evaluate() const;
+
+private:
+    struct StockColumns {
+        std::vector<double> riskRating;
+        std::vector<double> expectedReturn;
+        std::vector<double> volatility;
+        std::vector<double> dividendYield;
+        std::vector<double> amount;
+    };
+
+    struct BondColumns {
+        std::vector<double> riskRating;
+        std::vector<double> interestRate;
+        std::vector<int> termYears;
+        std::vector<double> inflationRate;
+        std::vector<unsigned char> callable;
+        std::vector<double> callableAdjustment;
+        std::vector<double> baseRiskWeight;
+        std::vector<double> inflationAdjustment;
+        std::vector<double> amount;
+    };
+
+    StockColumns stocks;
+    BondColumns bonds;
+};
+
+#endif // PORTFOLIO_H
@@ -0,0 +1,247 @@
+#include "PositionFile.h"
+#include "StrategyFormulas.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <istream>
+#include <vector>
+
+namespace {
+
+const char positionMagic[8] = {'I', 'N', 'V', 'P', 'O', 'S', '0', '1'};
+const std::uint32_t positionVersion = 1;
+
+PositionFileHeader makeHeader(std::uint64_t count) {
+    PositionFileHeader header;
+    std::memcpy(header.magic, positionMagic, sizeof(header.magic));
+    header.version = positionVersion;
+    header.recordSize = sizeof(PositionRecord);
+    header.recordCount = count;
+    header.reserved = 0;
+    return header;
+}
+
+PositionRecord emptyRecord(PositionKind kind, double amount, double riskRating) {
+    PositionRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.kind = kind;
+    record.amount = amount;
+    record.riskRating = riskRating;
+    return record;
+}
+
+} // namespace
+
+PositionFileWriter::PositionFileWriter(const std::string& path)
+    : file(std::fopen(path.c_str(), "wb")), written(0) {
+    if (!file)
+        throw InvestmentException("Cannot create position file: " + path);
+    PositionFileHeader header = makeHeader(0);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        throw InvestmentException("Cannot write position file header");
+    }
+}
+
+PositionFileWriter::~PositionFileWriter() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+void PositionFileWriter::add(const StockInvestment& stock, double amount) {
+    PositionRecord record = emptyRecord(StockPosition, amount, stock.getRiskRating());
+    record.params[0] = stock.getExpectedReturn();
+    record.params[1] = stock.getVolatilityFactor();
+    record.params[2] = stock.getDividendYield();
+    add(record);
+}
+
+void PositionFileWriter::add(const BondInvestment& bond, double amount) {
+    PositionRecord record = emptyRecord(BondPosition, amount, bond.getRiskRating());
+    record.callable = bond.isCallable() ? 1 : 0;
+    record.termYears = bond.getTermYears();
+    record.params[0] = bond.getInterestRate();
+    record.params[1] = bond.getInflationRate();
+    record.params[2] = bond.getCallableAdjustment();
+    record.params[3] = bond.getBaseRiskWeight();
+    record.params[4] = bond.getInflationAdjustment();
+    add(record);
+}
+
+void PositionFileWriter::add(const PositionRecord& record) {
+    if (!file)
+        throw InvestmentException("Position file is closed");
+    if (record.amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    if (std::fwrite(&record, sizeof(record), 1, file) != 1)
+        throw InvestmentException("Cannot write position record");
+    ++written;
+}
+
+std::uint64_t PositionFileWriter::count() const {
+    return written;
+}
+
+void PositionFileWriter::close() {
+    if (!file)
+        return;
+    PositionFileHeader header = makeHeader(written);
+    bool ok = std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = std::fclose(file) == 0 && ok;
+    file = nullptr;
+    if (!ok)
+        throw InvestmentException("Cannot finalize position file");
+}
+
+PositionFileReader::PositionFileReader(const std::string& path)
+    : mapping(path), first(nullptr), count(0) {
+    if (mapping.size() < sizeof(PositionFileHeader))
+        throw InvestmentException("Position file is truncated: " + path);
+    PositionFileHeader header;
+    std::memcpy(&header, mapping.data(), sizeof(header));
+    if (std::memcmp(header.magic, positionMagic, sizeof(header.magic)) != 0)
+        throw InvestmentException("Not a position file: " + path);
+    if (header.version != positionVersion || header.recordSize != sizeof(PositionRecord))
+        throw InvestmentException("Unsupported position file version: " + path);
+    if (header.recordCount > (mapping.size() - sizeof(header)) / sizeof(PositionRecord))
+        throw InvestmentException("Position file is truncated: " + path);
+    count = static_cast<std::size_t>(header.recordCount);
+    first = reinterpret_cast<const PositionRecord*>(mapping.data() + sizeof(header));
+}
+
+std::size_t PositionFileReader::size() const {
+    return count;
+}
+
+const PositionRecord* PositionFileReader::records() const {
+    return first;
+}
+
+void PositionFileReader::evaluate(const PositionSink& sink, std::size_t chunkSize) const {
+    if (chunkSize == 0)
+        chunkSize = 1;
+    mapping.adviseSequential();
+    std::vector<PositionValuation> results(std::min(chunkSize, count));
+    for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+        std::size_t end = std::min(count, begin + chunkSize);
+        for (std::size_t i = begin; i < end; ++i)
+            results[i - begin] = evaluatePosition(first[i]);
+        sink(begin, results.data(), end - begin);
+        mapping.release(sizeof(PositionFileHeader) + begin * sizeof(PositionRecord),
+                        (end - begin) * sizeof(PositionRecord));
+    }
+}
+
+// Same formulas and parameter checks as StockInvestment / BondInvestment
+PositionValuation evaluatePosition(const PositionRecord& record) {
+    const double amount = record.amount;
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+
+    PositionValuation result;
+    if (record.kind == StockPosition) {
+        const double expectedReturn = record.params[0];
+        const double volatility = record.params[1];
+        const double dividendYield = record.params[2];
+        if (expectedReturn < 0.0 || volatility < 0.0 || dividendYield < 0.0)
+            throw InvestmentException("Stock position has negative parameters");
+        result.risk = stockRisk(record.riskRating, volatility);
+        result.value = stockInvestValue(amount, result.risk, expectedReturn, volatility, dividendYield);
+        result.potentialReturn = amount * (expectedReturn + dividendYield + volatility * 0.05);
+        return result;
+    }
+    if (record.kind == BondPosition) {
+        const double interestRate = record.params[0];
+        const double inflationRate = record.params[1];
+        const double callableAdjustment = record.params[2];
+        const double baseRiskWeight = record.params[3];
+        const double inflationAdjustment = record.params[4];
+        if (interestRate < 0.0 || inflationRate < 0.0 || record.termYears <= 0 || callableAdjustment <= 0.0 ||
+            callableAdjustment > 1.0 || baseRiskWeight < 0.0 || inflationAdjustment <= 0.0)
+            throw InvestmentException("Bond position has invalid parameters");
+
+        const double effectiveRate = bondEffectiveRate(interestRate, inflationRate, record.callable != 0,
+                                                       callableAdjustment, inflationAdjustment);
+        result.value = amount * bondGrowthFactor(effectiveRate, static_cast<double>(record.termYears));
+        result.potentialReturn = amount * effectiveRate * record.termYears;
+        result.risk = baseRiskWeight * record.riskRating + (record.callable ? 0.1 : 0.0) + inflationRate * inflationAdjustment;
+        return result;
+    }
+    throw InvestmentException("Unknown position kind");
+}
+
+namespace {
+
+std::vector<std::string> splitCsvLine(const std::string& line) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t comma = line.find(',', start);
+        std::string field = line.substr(start, comma == std::string::npos ? std::string::npos : comma - start);
+        std::size_t first = field.find_first_not_of(" \t\r");
+        std::size_t last = field.find_last_not_of(" \t\r");
+        fields.push_back(first == std::string::npos ? std::string() : field.substr(first, last - first + 1));
+        if (comma == std::string::npos)
+            return fields;
+        start = comma + 1;
+    }
+}
+
+double parseNumber(const std::string& field, std::uint64_t lineNumber) {
+    char* end = nullptr;
+    double value = std::strtod(field.c_str(), &end);
+    if (field.empty() || *end != '\0')
+        throw InvestmentException("Invalid number '" + field + "' on CSV line " + std::to_string(lineNumber));
+    return value;
+}
+
+// Whole numbers only: "7.9" or a value beyond int is a malformed field, not a truncated one
+int parseInteger(const std::string& field, std::uint64_t lineNumber) {
+    char* end = nullptr;
+    errno = 0;
+    long value = std::strtol(field.c_str(), &end, 10);
+    if (field.empty() || *end != '\0' || errno == ERANGE || value < INT_MIN || value > INT_MAX)
+        throw InvestmentException("Invalid integer '" + field + "' on CSV line " + std::to_string(lineNumber));
+    return static_cast<int>(value);
+}
+
+} // namespace
+
+std::uint64_t convertCsvPositions(std::istream& csv, PositionFileWriter& writer) {
+    std::string line;
+    std::uint64_t lineNumber = 0;
+    std::uint64_t rows = 0;
+    while (std::getline(csv, line)) {
+        ++lineNumber;
+        std::vector<std::string> fields = splitCsvLine(line);
+        const std::string& type = fields[0];
+        if (type.empty() || type[0] == '#' || (lineNumber == 1 && type == "type"))
+            continue;
+
+        if (type == "stock") {
+            if (fields.size() != 6)
+                throw InvestmentException("Stock row needs 6 fields on CSV line " + std::to_string(lineNumber));
+            StockInvestment stock(parseNumber(fields[2], lineNumber), parseNumber(fields[3], lineNumber),
+                                  parseNumber(fields[4], lineNumber), parseNumber(fields[5], lineNumber));
+            writer.add(stock, parseNumber(fields[1], lineNumber));
+        } else if (type == "bond") {
+            if (fields.size() != 10)
+                throw InvestmentException("Bond row needs 10 fields on CSV line " + std::to_string(lineNumber));
+            BondInvestment bond(parseNumber(fields[3], lineNumber),
+                                parseInteger(fields[4], lineNumber),
+                                parseNumber(fields[5], lineNumber), parseNumber(fields[6], lineNumber) != 0.0,
+                                parseNumber(fields[7], lineNumber), parseNumber(fields[8], lineNumber),
+                                parseNumber(fields[9], lineNumber));
+            bond.setRiskRating(parseNumber(fields[2], lineNumber));
+            writer.add(bond, parseNumber(fields[1], lineNumber));
+        } else {
+            throw InvestmentException("Unknown position type '" + type + "' on CSV line " + std::to_string(lineNumber));
+        }
+        ++rows;
+    }
+    return rows;
+}
@@ -0,0 +1,97 @@
+#ifndef POSITION_FILE_H
+#define POSITION_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include "InvestmentSimulator.h"
+#include "MappedFile.h"
+
+// Binary position file: a 32-byte PositionFileHeader followed by fixed 64-byte
+// PositionRecords, both in host (little-endian) byte order.
+
+enum PositionKind : std::uint8_t {
+    StockPosition = 1,
+    BondPosition = 2
+};
+
+struct PositionFileHeader {
+    char magic[8];              // "INVPOS01"
+    std::uint32_t version;
+    std::uint32_t recordSize;
+    std::uint64_t recordCount;
+    std::uint64_t reserved;
+};
+
+// Stock params: expectedReturn, volatilityFactor, dividendYield
+// Bond params:  interestRate, inflationRate, callableAdjustment, baseRiskWeight, inflationAdjustment
+struct PositionRecord {
+    std::uint8_t kind;
+    std::uint8_t callable;
+    std::uint16_t reserved;
+    std::int32_t termYears;
+    double amount;
+    double riskRating;
+    double params[5];
+};
+
+static_assert(sizeof(PositionFileHeader) == 32, "PositionFileHeader layout changed");
+static_assert(sizeof(PositionRecord) == 64, "PositionRecord layout changed");
+
+struct PositionValuation {
+    double value;
+    double potentialReturn;
+    double risk;
+};
+
+// Receives valuations for records [firstIndex, firstIndex + count)
+typedef std::function<void(std::size_t firstIndex, const PositionValuation* results, std::size_t count)> PositionSink;
+
+class PositionFileWriter {
+public:
+    explicit PositionFileWriter(const std::string& path);
+    ~PositionFileWriter();
+
+    PositionFileWriter(const PositionFileWriter&) = delete;
+    PositionFileWriter& operator=(const PositionFileWriter&) = delete;
+
+    void add(const StockInvestment& stock, double amount);
+    void add(const BondInvestment& bond, double amount);
+    void add(const PositionRecord& record);
+    std::uint64_t count() const;
+    // Writes the final record count into the header; called by the destructor if needed
+    void close();
+
+private:
+    std::FILE* file;
+    std::uint64_t written;
+};
+
+class PositionFileReader {
+public:
+    explicit PositionFileReader(const std::string& path);
+
+    std::size_t size() const;
+    const PositionRecord* records() const;
+
+    // Values every record straight from the mapping, handing results to sink chunkSize at a time.
+    // Pages already consumed are released, so memory use does not grow with file size.
+    void evaluate(const PositionSink& sink, std::size_t chunkSize = 4096) const;
+
+private:
+    MappedFile mapping;
+    const PositionRecord* first;
+    std::size_t count;
+};
+
+PositionValuation evaluatePosition(const PositionRecord& record);
+
+// CSV rows: stock,amount,riskRating,expectedReturn,volatilityFactor,dividendYield
+//           bond,amount,riskRating,interestRate,termYears,inflationRate,callable,callableAdjustment,baseRiskWeight,inflationAdjustment
+// Blank lines, lines starting with '#' and a leading "type,..." header are skipped. Returns rows written.
+std::uint64_t convertCsvPositions(std::istream& csv, PositionFileWriter& writer);
+
+#endif // POSITION_FILE_H
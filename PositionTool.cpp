@@ -0,0 +1,27 @@
+#include <fstream>
+#include <iostream>
+#include "PositionFile.h"
+
+// Converts a CSV book into the binary position format read by PositionFileReader
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <positions.csv> <positions.bin>\n";
+        return 2;
+    }
+    try {
+        std::ifstream csv(argv[1]);
+        if (!csv.is_open()) {
+            std::cerr << "Failed to open " << argv[1] << "\n";
+            return 1;
+        }
+        PositionFileWriter writer(argv[2]);
+        std::uint64_t rows = convertCsvPositions(csv, writer);
+        writer.close();
+        std::cout << "Wrote " << rows << " positions to " << argv[2] << "\n";
+    }
+    catch(const InvestmentException& ex) {
+        std::cerr << "Investment Exception: " << ex.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
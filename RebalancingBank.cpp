@@ -0,0 +1,174 @@
+#include "RebalancingBank.h"
+#include "ThreadPool.h"
+
+RebalancingBank::RebalancingBank(const std::string& bankName, double initialFunds)
+    : account(bankName, initialFunds), pool(ThreadPool::shared()), parallelThreshold(256),
+      totalWeight(0.0), totalStale(false), weightedLegs(0) {}
+
+RebalancingBank::RebalancingBank(const std::string& bankName, double initialFunds, ThreadPool& threadPool,
+                                 std::size_t parallelLegThreshold)
+    : account(bankName, initialFunds), pool(threadPool), parallelThreshold(parallelLegThreshold),
+      totalWeight(0.0), totalStale(false), weightedLegs(0) {}
+
+std::size_t RebalancingBank::addLeg(std::shared_ptr<InvestmentStrategy> strategy, double weight) {
+    if (!strategy)
+        throw InvestmentException("Strategy cannot be null");
+    if (weight < 0.0)
+        throw InvestmentException("Strategy weight cannot be negative");
+    std::lock_guard<std::mutex> lock(mutex);
+    Leg leg;
+    leg.strategy = strategy;
+    leg.weight = weight;
+    leg.holding = 0.0;
+    legs.push_back(leg);
+    totalStale = true;
+    weightedLegs += weight > 0.0 ? 1 : 0;
+    return legs.size() - 1;
+}
+
+void RebalancingBank::checkLeg(std::size_t leg) const {
+    if (leg >= legs.size())
+        throw InvestmentException("Unknown strategy leg");
+}
+
+void RebalancingBank::applyWeight(std::size_t leg, double weight) {
+    double previous = legs[leg].weight;
+    weightedLegs += (weight > 0.0 ? 1 : 0) - (previous > 0.0 ? 1 : 0);
+    legs[leg].weight = weight;
+    totalStale = true;
+}
+
+// Summed in leg order, so the total is exactly the sum of the current weights whatever changes
+// led to them; executeInvestment and rebalance walk every leg anyway
+double RebalancingBank::weightSum() const {
+    if (totalStale) {
+        totalWeight = 0.0;
+        for (const Leg& leg : legs)
+            totalWeight += leg.weight;
+        totalStale = false;
+    }
+    return totalWeight;
+}
+
+void RebalancingBank::setWeight(std::size_t leg, double weight) {
+    if (weight < 0.0)
+        throw InvestmentException("Strategy weight cannot be negative");
+    std::lock_guard<std::mutex> lock(mutex);
+    checkLeg(leg);
+    applyWeight(leg, weight);
+}
+
+void RebalancingBank::setWeights(const std::vector<std::pair<std::size_t, double> >& changes) {
+    std::lock_guard<std::mutex> lock(mutex);
+    // Validate everything first so a bad entry leaves the weights untouched
+    for (const auto& change : changes) {
+        checkLeg(change.first);
+        if (change.second < 0.0)
+            throw InvestmentException("Strategy weight cannot be negative");
+    }
+    for (const auto& change : changes)
+        applyWeight(change.first, change.second);
+}
+
+double RebalancingBank::getWeight(std::size_t leg) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkLeg(leg);
+    return legs[leg].weight;
+}
+
+double RebalancingBank::getTargetFraction(std::size_t leg) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkLeg(leg);
+    return weightedLegs > 0 ? legs[leg].weight / weightSum() : 0.0;
+}
+
+std::size_t RebalancingBank::legCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return legs.size();
+}
+
+double RebalancingBank::executeInvestment(double amount, std::vector<double>* legValues) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    std::lock_guard<std::mutex> lock(mutex);
+    if (legs.empty())
+        throw InvestmentException("No investment strategy set");
+    if (weightedLegs == 0)
+        throw InvestmentException("Strategy weights must sum to a positive value");
+    if (!account.withdrawFunds(amount))
+        throw InvestmentException("Insufficient funds for investment");
+
+    const double perWeight = amount / weightSum();
+    scratch.resize(legs.size());
+    auto evaluate = [this, perWeight](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            const Leg& leg = legs[i];
+            scratch[i] = leg.weight > 0.0 ? leg.strategy->invest(leg.weight * perWeight) : 0.0;
+        }
+    };
+    try {
+        if (legs.size() >= parallelThreshold)
+            pool.parallelFor(legs.size(), 64, evaluate);
+        else
+            evaluate(0, legs.size());
+    } catch (...) {
+        account.depositFunds(amount);
+        throw;
+    }
+
+    double total = 0.0;
+    for (std::size_t i = 0; i < legs.size(); ++i) {
+        legs[i].holding += scratch[i];
+        total += scratch[i];
+    }
+    if (legValues)
+        legValues->assign(scratch.begin(), scratch.end());
+    return total;
+}
+
+double RebalancingBank::getHolding(std::size_t leg) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    checkLeg(leg);
+    return legs[leg].holding;
+}
+
+double RebalancingBank::getTotalHoldings() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    double total = 0.0;
+    for (const Leg& leg : legs)
+        total += leg.holding;
+    return total;
+}
+
+std::vector<double> RebalancingBank::rebalance() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (weightedLegs == 0)
+        throw InvestmentException("Strategy weights must sum to a positive value");
+    double total = 0.0;
+    for (const Leg& leg : legs)
+        total += leg.holding;
+    const double weights = weightSum();
+    std::vector<double> adjustments(legs.size());
+    for (std::size_t i = 0; i < legs.size(); ++i) {
+        double target = total * (legs[i].weight / weights);
+        adjustments[i] = target - legs[i].holding;
+        legs[i].holding = target;
+    }
+    return adjustments;
+}
+
+std::string RebalancingBank::getName() const {
+    return account.getName();
+}
+
+double RebalancingBank::getAvailableFunds() const {
+    return account.getAvailableFunds();
+}
+
+void RebalancingBank::depositFunds(double amount) {
+    account.depositFunds(amount);
+}
+
+bool RebalancingBank::withdrawFunds(double amount) {
+    return account.withdrawFunds(amount);
+}
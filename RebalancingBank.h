@@ -0,0 +1,74 @@
+#ifndef REBALANCING_BANK_H
+#define REBALANCING_BANK_H
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+class ThreadPool;
+
+// Bank that splits every investment across a weighted set of strategies (legs) and tracks the
+// value held in each leg. Weight updates cost O(changed legs); the total weight is summed again
+// over the legs on its next use, since an incremental total cancels when a large weight is
+// removed. Operations are serialized by an internal mutex; executeInvestment evaluates
+// large leg sets in parallel on the pool and sums the legs in leg order, so the aggregate does
+// not depend on the thread count.
+class RebalancingBank {
+public:
+    RebalancingBank(const std::string& bankName, double initialFunds = 0.0);
+    RebalancingBank(const std::string& bankName, double initialFunds, ThreadPool& pool,
+                    std::size_t parallelLegThreshold = 256);
+
+    RebalancingBank(const RebalancingBank&) = delete;
+    RebalancingBank& operator=(const RebalancingBank&) = delete;
+
+    // Returns the new leg's id; legs with weight 0 stay registered but receive nothing
+    std::size_t addLeg(std::shared_ptr<InvestmentStrategy> strategy, double weight);
+    void setWeight(std::size_t leg, double weight);
+    // Applies (leg, weight) pairs atomically with respect to executeInvestment
+    void setWeights(const std::vector<std::pair<std::size_t, double> >& changes);
+    double getWeight(std::size_t leg) const;
+    double getTargetFraction(std::size_t leg) const;
+    std::size_t legCount() const;
+
+    // Withdraws amount, invests amount * weight / totalWeight in every leg and returns the summed
+    // result; legValues, when given, receives the per-leg results
+    double executeInvestment(double amount, std::vector<double>* legValues = nullptr);
+
+    // Value currently held in each leg, from the investments made so far
+    double getHolding(std::size_t leg) const;
+    double getTotalHoldings() const;
+    // Moves holdings to the target weights and returns the per-leg adjustments (positive = buy)
+    std::vector<double> rebalance();
+
+    std::string getName() const;
+    double getAvailableFunds() const;
+    void depositFunds(double amount);
+    bool withdrawFunds(double amount);
+
+private:
+    struct Leg {
+        std::shared_ptr<InvestmentStrategy> strategy;
+        double weight;
+        double holding;
+    };
+
+    void checkLeg(std::size_t leg) const;
+    void applyWeight(std::size_t leg, double weight);
+    double weightSum() const;
+
+    Bank account;
+    ThreadPool& pool;
+    std::size_t parallelThreshold;
+    mutable std::mutex mutex;
+    std::vector<Leg> legs;
+    mutable double totalWeight;    // valid unless totalStale
+    mutable bool totalStale;
+    std::size_t weightedLegs;      // legs with positive weight
+    std::vector<double> scratch;
+};
+
+#endif // REBALANCING_BANK_H
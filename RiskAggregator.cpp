@@ -0,0 +1,188 @@
+#include "RiskAggregator.h"
+#include <algorithm>
+#include <cmath>
+
+RiskBook::RiskBook(std::size_t buckets)
+    : bucketTotal(buckets), correlations(buckets * buckets, 0.0) {
+    if (buckets == 0)
+        throw InvestmentException("Risk book needs at least one bucket");
+    for (std::size_t b = 0; b < buckets; ++b)
+        correlations[b * buckets + b] = 1.0;
+}
+
+void RiskBook::reserve(std::size_t positions) {
+    exposure.reserve(positions);
+    risk.reserve(positions);
+    bucket.reserve(positions);
+}
+
+std::size_t RiskBook::add(const InvestmentStrategy& strategy, double amount, std::size_t positionBucket) {
+    return addRisk(strategy.calculateRisk(), amount, positionBucket);
+}
+
+std::size_t RiskBook::addRisk(double positionRisk, double amount, std::size_t positionBucket) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    checkBucket(positionBucket);
+    exposure.push_back(amount);
+    risk.push_back(positionRisk);
+    bucket.push_back(static_cast<std::uint32_t>(positionBucket));
+    return exposure.size() - 1;
+}
+
+void RiskBook::addPortfolio(const Portfolio& portfolio, std::size_t stockBucket, std::size_t bondBucket) {
+    checkBucket(stockBucket);
+    checkBucket(bondBucket);
+    PortfolioValuation valuation;
+    portfolio.evaluate(valuation);
+    reserve(size() + portfolio.size());
+    for (std::size_t i = 0; i < portfolio.stockCount(); ++i)
+        addRisk(valuation.stockRisks[i], portfolio.stockAmount(i), stockBucket);
+    for (std::size_t i = 0; i < portfolio.bondCount(); ++i)
+        addRisk(valuation.bondRisks[i], portfolio.bondAmount(i), bondBucket);
+}
+
+void RiskBook::setCorrelation(std::size_t a, std::size_t b, double rho) {
+    checkBucket(a);
+    checkBucket(b);
+    if (!(rho >= -1.0 && rho <= 1.0))
+        throw InvestmentException("Correlation must be between -1 and 1");
+    correlations[a * bucketTotal + b] = rho;
+    correlations[b * bucketTotal + a] = rho;
+}
+
+double RiskBook::correlation(std::size_t a, std::size_t b) const {
+    checkBucket(a);
+    checkBucket(b);
+    return correlations[a * bucketTotal + b];
+}
+
+std::size_t RiskBook::size() const {
+    return exposure.size();
+}
+
+std::size_t RiskBook::bucketCount() const {
+    return bucketTotal;
+}
+
+void RiskBook::clear() {
+    exposure.clear();
+    risk.clear();
+    bucket.clear();
+}
+
+const std::vector<double>& RiskBook::exposures() const {
+    return exposure;
+}
+
+const std::vector<double>& RiskBook::risks() const {
+    return risk;
+}
+
+const std::vector<std::uint32_t>& RiskBook::buckets() const {
+    return bucket;
+}
+
+void RiskBook::checkBucket(std::size_t b) const {
+    if (b >= bucketTotal)
+        throw InvestmentException("Risk bucket out of range");
+}
+
+namespace {
+
+// Per-bucket sums; with s = exposure * risk, the bucket's variance is
+// rho_aa * riskSum^2 + (1 - rho_aa) * riskSquares
+struct BucketPartial {
+    double exposure;
+    double riskSum;
+    double riskSquares;
+    double count;
+};
+
+void mergeInto(BucketPartial* into, const BucketPartial* from, std::size_t buckets) {
+    for (std::size_t b = 0; b < buckets; ++b) {
+        into[b].exposure += from[b].exposure;
+        into[b].riskSum += from[b].riskSum;
+        into[b].riskSquares += from[b].riskSquares;
+        into[b].count += from[b].count;
+    }
+}
+
+} // namespace
+
+RiskAggregator::RiskAggregator(ThreadPool& threadPool, std::size_t block)
+    : pool(threadPool), blockSize(block == 0 ? 1 : block) {}
+
+void RiskAggregator::aggregate(const RiskBook& book, RiskSummary& out) const {
+    const std::size_t n = book.size();
+    const std::size_t buckets = book.bucketCount();
+    const std::size_t blocks = n == 0 ? 1 : (n + blockSize - 1) / blockSize;
+    std::vector<BucketPartial> partials(blocks * buckets);
+
+    const double* exposure = book.exposures().data();
+    const double* risk = book.risks().data();
+    const std::uint32_t* bucket = book.buckets().data();
+    pool.parallelFor(blocks, 1, [&](std::size_t first, std::size_t last) {
+        for (std::size_t block = first; block < last; ++block) {
+            BucketPartial* partial = &partials[block * buckets];
+            const std::size_t end = std::min(n, (block + 1) * blockSize);
+            for (std::size_t i = block * blockSize; i < end; ++i) {
+                const double weighted = exposure[i] * risk[i];
+                BucketPartial& p = partial[bucket[i]];
+                p.exposure += exposure[i];
+                p.riskSum += weighted;
+                p.riskSquares += weighted * weighted;
+                p.count += 1.0;
+            }
+        }
+    });
+
+    // Fixed pairwise tree: block i absorbs block i + stride at each level
+    for (std::size_t stride = 1; stride < blocks; stride *= 2) {
+        const std::size_t pairs = (blocks - stride + 2 * stride - 1) / (2 * stride);
+        pool.parallelFor(pairs, 16, [&](std::size_t first, std::size_t last) {
+            for (std::size_t pair = first; pair < last; ++pair) {
+                const std::size_t into = pair * 2 * stride;
+                mergeInto(&partials[into * buckets], &partials[(into + stride) * buckets], buckets);
+            }
+        });
+    }
+    const BucketPartial* total = partials.data();
+
+    out.buckets.resize(buckets);
+    double totalExposure = 0.0;
+    double totalRiskSum = 0.0;
+    double variance = 0.0;
+    for (std::size_t a = 0; a < buckets; ++a) {
+        const double rhoSelf = book.correlation(a, a);
+        double crossSum = 0.0;
+        for (std::size_t b = 0; b < buckets; ++b)
+            crossSum += book.correlation(a, b) * total[b].riskSum;
+        const double contribution = total[a].riskSum * crossSum + (1.0 - rhoSelf) * total[a].riskSquares;
+        const double bucketVariance = rhoSelf * total[a].riskSum * total[a].riskSum + (1.0 - rhoSelf) * total[a].riskSquares;
+
+        RiskBucketSummary& summary = out.buckets[a];
+        summary.positions = static_cast<std::size_t>(total[a].count);
+        summary.exposure = total[a].exposure;
+        summary.weightedRisk = total[a].exposure > 0.0 ? total[a].riskSum / total[a].exposure : 0.0;
+        summary.volatility = total[a].exposure > 0.0 ? std::sqrt(std::max(bucketVariance, 0.0)) / total[a].exposure : 0.0;
+        summary.varianceShare = contribution;
+
+        totalExposure += total[a].exposure;
+        totalRiskSum += total[a].riskSum;
+        variance += contribution;
+    }
+    for (std::size_t a = 0; a < buckets; ++a)
+        out.buckets[a].varianceShare = variance > 0.0 ? out.buckets[a].varianceShare / variance : 0.0;
+
+    out.positions = n;
+    out.exposure = totalExposure;
+    out.weightedRisk = totalExposure > 0.0 ? totalRiskSum / totalExposure : 0.0;
+    out.volatility = totalExposure > 0.0 ? std::sqrt(std::max(variance, 0.0)) / totalExposure : 0.0;
+}
+
+RiskSummary RiskAggregator::aggregate(const RiskBook& book) const {
+    RiskSummary out;
+    aggregate(book, out);
+    return out;
+}
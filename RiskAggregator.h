@@ -0,0 +1,80 @@
+#ifndef RISK_AGGREGATOR_H
+#define RISK_AGGREGATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "InvestmentSimulator.h"
+#include "Portfolio.h"
+#include "ThreadPool.h"
+
+// Positions for risk aggregation, stored column-wise: exposure (the amount invested), the
+// strategy's calculateRisk() taken as the position's standalone volatility, and a bucket (asset
+// class, sector, desk, ...). Two positions i != j in buckets a and b have covariance
+// correlation(a, b) * risk_i * risk_j; correlations default to 1 within a bucket and 0 across.
+class RiskBook {
+public:
+    explicit RiskBook(std::size_t buckets = 1);
+
+    void reserve(std::size_t positions);
+    std::size_t add(const InvestmentStrategy& strategy, double amount, std::size_t bucket = 0);
+    std::size_t addRisk(double risk, double amount, std::size_t bucket = 0);
+    // Adds every stock and bond position of the portfolio with its calculateRisk() value
+    void addPortfolio(const Portfolio& portfolio, std::size_t stockBucket, std::size_t bondBucket);
+
+    void setCorrelation(std::size_t a, std::size_t b, double rho);
+    double correlation(std::size_t a, std::size_t b) const;
+
+    std::size_t size() const;
+    std::size_t bucketCount() const;
+    void clear();
+
+    const std::vector<double>& exposures() const;
+    const std::vector<double>& risks() const;
+    const std::vector<std::uint32_t>& buckets() const;
+
+private:
+    void checkBucket(std::size_t bucket) const;
+
+    std::size_t bucketTotal;
+    std::vector<double> exposure;
+    std::vector<double> risk;
+    std::vector<std::uint32_t> bucket;
+    std::vector<double> correlations;       // bucketTotal x bucketTotal, symmetric
+};
+
+struct RiskBucketSummary {
+    std::size_t positions;
+    double exposure;
+    double weightedRisk;            // exposure-weighted mean of calculateRisk()
+    double volatility;              // the bucket on its own, as a fraction of its exposure
+    double varianceShare;           // Euler contribution to portfolio variance; shares sum to 1
+};
+
+struct RiskSummary {
+    std::size_t positions;
+    double exposure;
+    double weightedRisk;
+    double volatility;              // sqrt(w' C w) over the normalized exposure weights; equals
+                                    // weightedRisk when every pair is perfectly correlated
+    std::vector<RiskBucketSummary> buckets;
+};
+
+// Aggregates a RiskBook on a thread pool. Positions are split into fixed blocks of blockSize;
+// each block sums per-bucket partials in index order and the blocks are combined in a fixed
+// pairwise tree. The block layout depends only on the book and blockSize, so results are
+// bit-identical for any pool size. Work is O(positions + buckets^2).
+class RiskAggregator {
+public:
+    explicit RiskAggregator(ThreadPool& pool = ThreadPool::shared(), std::size_t blockSize = 4096);
+
+    // out's vectors are resized and reused between calls
+    void aggregate(const RiskBook& book, RiskSummary& out) const;
+    RiskSummary aggregate(const RiskBook& book) const;
+
+private:
+    ThreadPool& pool;
+    std::size_t blockSize;
+};
+
+#endif // RISK_AGGREGATOR_H
@@ -0,0 +1,121 @@
+#include "ScenarioGrid.h"
+#include <cmath>
+#include <mutex>
+
+ParameterRange::ParameterRange(double value)
+    : from(value), to(value), count(1) {}
+
+ParameterRange::ParameterRange(double first, double last, std::size_t steps)
+    : from(first), to(last), count(steps) {
+    if (steps == 0)
+        throw InvestmentException("Parameter range needs at least one value");
+}
+
+double ParameterRange::at(std::size_t i) const {
+    if (count == 1)
+        return from;
+    return from + (to - from) * static_cast<double>(i) / static_cast<double>(count - 1);
+}
+
+ScenarioGrid::ScenarioGrid(const std::vector<ParameterRange>& parameterRanges)
+    : ranges(parameterRanges), total(1) {
+    if (ranges.empty())
+        throw InvestmentException("Scenario grid needs at least one dimension");
+    for (const auto& range : ranges)
+        total *= range.count;
+}
+
+std::size_t ScenarioGrid::size() const {
+    return total;
+}
+
+std::size_t ScenarioGrid::dimensions() const {
+    return ranges.size();
+}
+
+const ParameterRange& ScenarioGrid::range(std::size_t dimension) const {
+    return ranges.at(dimension);
+}
+
+void ScenarioGrid::point(std::size_t index, double* values) const {
+    for (std::size_t d = ranges.size(); d-- > 0;) {
+        values[d] = ranges[d].at(index % ranges[d].count);
+        index /= ranges[d].count;
+    }
+}
+
+void ScenarioGrid::seek(std::size_t index, std::size_t* positions, double* values) const {
+    for (std::size_t d = ranges.size(); d-- > 0;) {
+        positions[d] = index % ranges[d].count;
+        values[d] = ranges[d].at(positions[d]);
+        index /= ranges[d].count;
+    }
+}
+
+void ScenarioGrid::advance(std::size_t* positions, double* values) const {
+    for (std::size_t d = ranges.size(); d-- > 0;) {
+        if (++positions[d] < ranges[d].count) {
+            values[d] = ranges[d].at(positions[d]);
+            return;
+        }
+        positions[d] = 0;
+        values[d] = ranges[d].from;
+    }
+}
+
+ScenarioRunner::ScenarioRunner(ThreadPool& threadPool, std::size_t chunk)
+    : pool(threadPool), chunkSize(chunk == 0 ? 1 : chunk) {}
+
+namespace {
+
+// Evaluates the grid chunk by chunk; each chunk reuses one strategy copy and one result buffer
+template <typename Strategy, typename Configure>
+void runGrid(ThreadPool& pool, std::size_t chunkSize, const ScenarioGrid& grid, const Strategy& base,
+             double amount, const ScenarioSink& sink, std::size_t expectedDimensions, Configure configure) {
+    if (grid.dimensions() != expectedDimensions)
+        throw InvestmentException("Scenario grid has the wrong number of dimensions");
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+
+    std::mutex sinkMutex;
+    pool.parallelFor(grid.size(), chunkSize, [&](std::size_t begin, std::size_t end) {
+        Strategy strategy(base);
+        std::vector<ScenarioResult> results(end - begin);
+        std::vector<std::size_t> positions(expectedDimensions);
+        std::vector<double> values(expectedDimensions);
+        grid.seek(begin, positions.data(), values.data());
+        for (std::size_t index = begin; index < end; ++index) {
+            if (index != begin)
+                grid.advance(positions.data(), values.data());
+            configure(strategy, values.data());
+            ScenarioResult& result = results[index - begin];
+            result.index = index;
+            result.value = strategy.invest(amount);
+            result.potentialReturn = strategy.calculatePotentialReturn(amount);
+            result.risk = strategy.calculateRisk();
+        }
+        std::lock_guard<std::mutex> lock(sinkMutex);
+        sink(results.data(), results.size());
+    });
+}
+
+} // namespace
+
+void ScenarioRunner::runBonds(const ScenarioGrid& grid, const BondInvestment& base, double amount,
+                              const ScenarioSink& sink) const {
+    // The grid supplies the interest rate, which a curve-attached bond would refuse
+    BondInvestment detached(base);
+    detached.setYieldCurve(nullptr);
+    runGrid(pool, chunkSize, grid, detached, amount, sink, 4, [](BondInvestment& bond, const double* values) {
+        bond.setTerms(values[0], static_cast<int>(std::lround(values[1])), values[2], values[3] >= 0.5);
+    });
+}
+
+void ScenarioRunner::runStocks(const ScenarioGrid& grid, const StockInvestment& base, double amount,
+                               const ScenarioSink& sink) const {
+    runGrid(pool, chunkSize, grid, base, amount, sink, 3, [](StockInvestment& stock, const double* values) {
+        stock.setExpectedReturn(values[0]);
+        stock.setVolatilityFactor(values[1]);
+        stock.setDividendYield(values[2]);
+    });
+}
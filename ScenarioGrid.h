@@ -0,0 +1,67 @@
+#ifndef SCENARIO_GRID_H
+#define SCENARIO_GRID_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "InvestmentSimulator.h"
+#include "ThreadPool.h"
+
+// Evenly spaced values from `from` to `to` inclusive
+struct ParameterRange {
+    double from;
+    double to;
+    std::size_t count;
+
+    ParameterRange(double value);
+    ParameterRange(double first, double last, std::size_t steps);
+    double at(std::size_t i) const;
+};
+
+// Cartesian product of parameter ranges, addressed by a flat index.
+// Points are decoded on demand, so the grid itself is never materialized.
+class ScenarioGrid {
+public:
+    explicit ScenarioGrid(const std::vector<ParameterRange>& ranges);
+
+    std::size_t size() const;
+    std::size_t dimensions() const;
+    const ParameterRange& range(std::size_t dimension) const;
+    // Writes dimensions() values; the last range varies fastest
+    void point(std::size_t index, double* values) const;
+    // Decodes index into per-dimension positions plus values, for walking with advance()
+    void seek(std::size_t index, std::size_t* positions, double* values) const;
+    // Steps positions/values to the next index, touching only the dimensions that roll over
+    void advance(std::size_t* positions, double* values) const;
+
+private:
+    std::vector<ParameterRange> ranges;
+    std::size_t total;
+};
+
+struct ScenarioResult {
+    std::size_t index;
+    double value;
+    double potentialReturn;
+    double risk;
+};
+
+// Receives results one chunk at a time; calls are serialized, chunks arrive in no particular order
+typedef std::function<void(const ScenarioResult* results, std::size_t count)> ScenarioSink;
+
+class ScenarioRunner {
+public:
+    explicit ScenarioRunner(ThreadPool& pool = ThreadPool::shared(), std::size_t chunkSize = 2048);
+
+    // Grid dimensions: interest rate, term years, inflation rate, callable (0 or 1). A base bond
+    // on a yield curve is evaluated detached from it, at the grid's flat rates.
+    void runBonds(const ScenarioGrid& grid, const BondInvestment& base, double amount, const ScenarioSink& sink) const;
+    // Grid dimensions: expected return, volatility factor, dividend yield
+    void runStocks(const ScenarioGrid& grid, const StockInvestment& base, double amount, const ScenarioSink& sink) const;
+
+private:
+    ThreadPool& pool;
+    std::size_t chunkSize;
+};
+
+#endif // SCENARIO_GRID_H
@@ -0,0 +1,40 @@
+#include "Sensitivity.h"
+#include "StrategyFormulas.h"
+
+StockSensitivities investSensitivities(const StockInvestment& stock, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    typedef Dual<5> D;
+    const D volatility = D::seed(stock.getVolatilityFactor(), 3);
+    const D value = stockInvestValue(D::seed(amount, 0), stockRisk(D::seed(stock.getRiskRating(), 1), volatility),
+                                     D::seed(stock.getExpectedReturn(), 2), volatility,
+                                     D::seed(stock.getDividendYield(), 4));
+    StockSensitivities out;
+    out.value = value.value;
+    out.amount = value.derivative[0];
+    out.riskRating = value.derivative[1];
+    out.expectedReturn = value.derivative[2];
+    out.volatilityFactor = value.derivative[3];
+    out.dividendYield = value.derivative[4];
+    return out;
+}
+
+BondSensitivities investSensitivities(const BondInvestment& bond, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    typedef Dual<6> D;
+    const D rate = bondEffectiveRate(D::seed(bond.getInterestRate(), 1), D::seed(bond.getInflationRate(), 3),
+                                     bond.isCallable(), D::seed(bond.getCallableAdjustment(), 4),
+                                     D::seed(bond.getInflationAdjustment(), 5));
+    const D growth = bondGrowthFactor(rate, D::seed(static_cast<double>(bond.getTermYears()), 2));
+    const D value = D::seed(amount, 0) * growth;
+    BondSensitivities out;
+    out.value = value.value;
+    out.amount = value.derivative[0];
+    out.interestRate = value.derivative[1];
+    out.termYears = value.derivative[2];
+    out.inflationRate = value.derivative[3];
+    out.callableAdjustment = value.derivative[4];
+    out.inflationAdjustment = value.derivative[5];
+    return out;
+}
@@ -0,0 +1,108 @@
+#ifndef SENSITIVITY_H
+#define SENSITIVITY_H
+
+#include <cmath>
+#include <cstddef>
+#include "InvestmentSimulator.h"
+
+// Forward-mode dual number carrying N partial derivatives alongside its value
+template <std::size_t N>
+struct Dual {
+    double value;
+    double derivative[N];
+
+    Dual(double v = 0.0) : value(v) {
+        for (std::size_t i = 0; i < N; ++i)
+            derivative[i] = 0.0;
+    }
+
+    // The independent variable with index `variable`
+    static Dual seed(double v, std::size_t variable) {
+        Dual x(v);
+        x.derivative[variable] = 1.0;
+        return x;
+    }
+};
+
+template <std::size_t N>
+inline Dual<N> operator+(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.value + b.value);
+    for (std::size_t i = 0; i < N; ++i)
+        r.derivative[i] = a.derivative[i] + b.derivative[i];
+    return r;
+}
+
+template <std::size_t N>
+inline Dual<N> operator-(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.value - b.value);
+    for (std::size_t i = 0; i < N; ++i)
+        r.derivative[i] = a.derivative[i] - b.derivative[i];
+    return r;
+}
+
+template <std::size_t N>
+inline Dual<N> operator*(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> r(a.value * b.value);
+    for (std::size_t i = 0; i < N; ++i)
+        r.derivative[i] = a.derivative[i] * b.value + a.value * b.derivative[i];
+    return r;
+}
+
+template <std::size_t N>
+inline Dual<N> operator+(double a, const Dual<N>& b) {
+    Dual<N> r(b);
+    r.value = a + b.value;
+    return r;
+}
+
+template <std::size_t N>
+inline Dual<N> operator*(const Dual<N>& a, double b) {
+    Dual<N> r(a.value * b);
+    for (std::size_t i = 0; i < N; ++i)
+        r.derivative[i] = a.derivative[i] * b;
+    return r;
+}
+
+template <std::size_t N>
+inline bool operator>(const Dual<N>& a, const Dual<N>& b) {
+    return a.value > b.value;
+}
+
+// base^exponent with both sides differentiable; the value is std::pow's, bit for bit
+template <std::size_t N>
+inline Dual<N> pow(const Dual<N>& base, const Dual<N>& exponent) {
+    Dual<N> r(std::pow(base.value, exponent.value));
+    const double dBase = exponent.value * std::pow(base.value, exponent.value - 1.0);
+    const double dExponent = base.value > 0.0 ? r.value * std::log(base.value) : 0.0;
+    for (std::size_t i = 0; i < N; ++i)
+        r.derivative[i] = dBase * base.derivative[i] + dExponent * exponent.derivative[i];
+    return r;
+}
+
+// Value of invest(amount) and its partial derivatives, from one forward-mode pass through the
+// same formula invest() uses
+struct StockSensitivities {
+    double value;
+    double amount;
+    double riskRating;
+    double expectedReturn;
+    double volatilityFactor;
+    double dividendYield;
+};
+
+// termYears is differentiated as if the term were continuous. At the inflation branch the
+// derivative is the one-sided derivative of the branch taken.
+struct BondSensitivities {
+    double value;
+    double amount;
+    double interestRate;
+    double termYears;
+    double inflationRate;
+    double callableAdjustment;      // zero for non-callable bonds
+    double inflationAdjustment;
+};
+
+StockSensitivities investSensitivities(const StockInvestment& stock, double amount);
+BondSensitivities investSensitivities(const BondInvestment& bond, double amount);
+
+#endif // SENSITIVITY_H
@@ -1,4 +1,10 @@
 #include "InvestmentSimulator.h"
+#include "CounterRng.h"
+#include "Metrics.h"
+#include "StrategyFormulas.h"
+#include "ThreadPool.h"
+#include <typeinfo>
+#include <vector>
 
 StockInvestment::StockInvestment(double risk, double returnRate, double volatility, double divYield)
     : InvestmentStrategy("Stock", risk), expectedReturn(returnRate), volatilityFactor(volatility), dividendYield(divYield)
@@ -9,25 +15,79 @@ StockInvestment::StockInvestment(double risk, double returnRate, double volatili
         throw InvestmentException("Volatility factor cannot be negative");
     if (divYield < 0.0)
         throw InvestmentException("Dividend yield cannot be negative");
+    updateFingerprint();
 }
 
-double StockInvestment::invest(double amount) const {
-    if (amount <= 0)
-        throw InvestmentException("Investment amount must be positive");
-    double baseGrowth = amount * expectedReturn * (1.0 + calculateRisk());
-    double dividendContribution = amount * dividendYield;
-    double volatilityAdjustment = amount * volatilityFactor * 0.05;
-    return amount + baseGrowth + dividendContribution + volatilityAdjustment;
+InvestmentResult StockInvestment::tryInvest(double amount) const {
+    INVESTMENT_METRIC_COUNT(MetricStrategyInvestments);
+    INVESTMENT_METRIC_TIME(MetricStrategyInvestLatency);
+    if (amount <= 0) {
+        INVESTMENT_METRIC_COUNT(MetricInvalidAmount);
+        return InvestmentResult::failure(StatusInvalidAmount);
+    }
+    return InvestmentResult::success(stockInvestValue(amount, calculateRisk(), expectedReturn, volatilityFactor, dividendYield));
 }
 
-double StockInvestment::calculatePotentialReturn(double amount) const {
+InvestmentResult StockInvestment::tryCalculatePotentialReturn(double amount) const {
     if (amount <= 0)
-        throw InvestmentException("Investment amount must be positive");
-    return amount * (expectedReturn + dividendYield + volatilityFactor * 0.05);
+        return InvestmentResult::failure(StatusInvalidAmount);
+    return InvestmentResult::success(amount * (expectedReturn + dividendYield + volatilityFactor * 0.05));
 }
 
 double StockInvestment::calculateRisk() const {
-    return riskRating * 1.5 + volatilityFactor;
+    return stockRisk(riskRating, volatilityFactor);
+}
+
+void StockInvestment::investBatch(const double* amounts, double* out, std::size_t n) const {
+    if (typeid(*this) != typeid(StockInvestment)) {
+        InvestmentStrategy::investBatch(amounts, out, n);   // a subclass may override invest()
+        return;
+    }
+    validateBatch(amounts, out, n);
+    // Loop invariants hoisted; the per-element expression mirrors invest() term by term
+    const double growthMultiplier = 1.0 + calculateRisk();
+    const double returnRate = expectedReturn;
+    const double divYield = dividendYield;
+    const double volatility = volatilityFactor;
+    for (std::size_t i = 0; i < n; ++i) {
+        const double amount = amounts[i];
+        out[i] = amount + amount * returnRate * growthMultiplier + amount * divYield + amount * volatility * 0.05;
+    }
+}
+
+MonteCarloResult StockInvestment::simulate(double amount, const MonteCarloSettings& settings) const {
+    return simulate(amount, settings, ThreadPool::shared());
+}
+
+MonteCarloResult StockInvestment::simulate(double amount, const MonteCarloSettings& settings, ThreadPool& pool) const {
+    validateSimulation(amount, settings);
+
+    std::size_t steps = static_cast<std::size_t>(std::ceil(settings.horizonYears * settings.stepsPerYear));
+    double dt = settings.horizonYears / static_cast<double>(steps);
+    double sigma = volatilityFactor;
+    double drift = (expectedReturn + dividendYield - 0.5 * sigma * sigma) * dt;
+    double diffusion = sigma * std::sqrt(dt);
+
+    // Each path owns its RNG stream, so the outcome is independent of how paths are split across threads
+    std::vector<double> terminal(settings.paths);
+    pool.parallelFor(settings.paths, 1024, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t path = begin; path < end; ++path) {
+            CounterRng rng(settings.seed, path);
+            double logGrowth = 0.0;
+            for (std::size_t step = 0; step < steps; ++step)
+                logGrowth += drift + diffusion * rng.nextNormal();
+            terminal[path] = amount * std::exp(logGrowth);
+        }
+    });
+
+    return summarizeTerminalValues(terminal, amount, settings.confidence);
+}
+
+ParameterFingerprint StockInvestment::computeFingerprint() const {
+    ParameterFingerprint hash = InvestmentStrategy::computeFingerprint();
+    hash = mixFingerprint(hash, expectedReturn);
+    hash = mixFingerprint(hash, volatilityFactor);
+    return mixFingerprint(hash, dividendYield);
 }
 
 double StockInvestment::getExpectedReturn() const {
@@ -39,6 +99,7 @@ void StockInvestment::setExpectedReturn(double returnRate) {
         expectedReturn = returnRate;
     else
         throw InvestmentException("Expected return cannot be negative");
+    updateFingerprint();
 }
 
 double StockInvestment::getVolatilityFactor() const {
@@ -50,6 +111,7 @@ void StockInvestment::setVolatilityFactor(double volatility) {
         volatilityFactor = volatility;
     else
         throw InvestmentException("Volatility factor cannot be negative");
+    updateFingerprint();
 }
 
 double StockInvestment::getDividendYield() const {
@@ -61,4 +123,5 @@ void StockInvestment::setDividendYield(double divYield) {
         dividendYield = divYield;
     else
         throw InvestmentException("Dividend yield cannot be negative");
+    updateFingerprint();
 }
@@ -0,0 +1,56 @@
+#include "StrategyArena.h"
+#include "InvestmentSimulator.h"
+#include <cstdint>
+
+StrategyArena::StrategyArena(std::size_t blockSize)
+    : blockBytes(blockSize), currentBlock(0), offset(0), last(nullptr), objects(0) {
+    if (blockSize == 0)
+        throw InvestmentException("Arena block size must be positive");
+}
+
+StrategyArena::~StrategyArena() {
+    reset();
+}
+
+void StrategyArena::reset() {
+    while (last) {
+        Record* record = last;
+        last = record->previous;
+        record->destroy(record->object);
+    }
+    objects = 0;
+    currentBlock = 0;
+    offset = 0;
+}
+
+// Bumps within the current block; moves on to the next block (reusing one kept by reset, or
+// allocating a new one at least large enough for the request) when the request does not fit
+void* StrategyArena::allocate(std::size_t size, std::size_t alignment) {
+    while (currentBlock < blocks.size()) {
+        Block& block = blocks[currentBlock];
+        std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block.memory.get());
+        std::uintptr_t aligned = (base + offset + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+        if (aligned + size <= base + block.size) {
+            offset = static_cast<std::size_t>(aligned - base) + size;
+            return reinterpret_cast<void*>(aligned);
+        }
+        ++currentBlock;
+        offset = 0;
+    }
+    Block block;
+    block.size = size + alignment > blockBytes ? size + alignment : blockBytes;
+    block.memory.reset(new char[block.size]);
+    blocks.push_back(std::move(block));
+    return allocate(size, alignment);
+}
+
+std::size_t StrategyArena::objectCount() const {
+    return objects;
+}
+
+std::size_t StrategyArena::bytesReserved() const {
+    std::size_t total = 0;
+    for (const Block& block : blocks)
+        total += block.size;
+    return total;
+}
@@ -0,0 +1,76 @@
+#ifndef STRATEGY_ARENA_H
+#define STRATEGY_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Monotonic arena for strategies that are created and discarded together, such as the objects
+// of one scenario run. Objects are bump-allocated from large blocks with no per-object heap
+// allocation or control block, and reset() destroys them all at once while keeping the blocks
+// for the next run. Not thread-safe: give each thread its own arena.
+//
+// Pointers from create() stay valid until reset() or destruction, and can be handed to
+// Bank::setBorrowedStrategy. The built-in strategy names fit std::string's inline buffer, so
+// an arena-built Stock, Bond or Crypto strategy allocates nothing on the heap.
+class StrategyArena {
+public:
+    explicit StrategyArena(std::size_t blockBytes = 64 * 1024);
+    ~StrategyArena();
+
+    StrategyArena(const StrategyArena&) = delete;
+    StrategyArena& operator=(const StrategyArena&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        // The object follows its record, padded out to the object's alignment
+        const std::size_t objectOffset = (sizeof(Record) + alignof(T) - 1) & ~(alignof(T) - 1);
+        void* memory = allocate(objectOffset + sizeof(T), alignof(T) > alignof(Record) ? alignof(T) : alignof(Record));
+        Record* record = static_cast<Record*>(memory);
+        T* object = new (static_cast<char*>(memory) + objectOffset) T(std::forward<Args>(args)...);
+        // Linked only once constructed, so a throwing constructor leaves nothing to destroy
+        record->destroy = &destroyObject<T>;
+        record->object = object;
+        record->previous = last;
+        last = record;
+        ++objects;
+        return object;
+    }
+
+    // Destroys every object, newest first, and rewinds to the first block
+    void reset();
+
+    std::size_t objectCount() const;
+    std::size_t bytesReserved() const;
+
+private:
+    // Precedes each object; the chain runs from the newest object back to the oldest
+    struct Record {
+        void (*destroy)(void*);
+        void* object;
+        Record* previous;
+    };
+
+    struct Block {
+        std::unique_ptr<char[]> memory;
+        std::size_t size;
+    };
+
+    template <typename T>
+    static void destroyObject(void* object) {
+        static_cast<T*>(object)->~T();
+    }
+
+    void* allocate(std::size_t size, std::size_t alignment);
+
+    std::vector<Block> blocks;
+    std::size_t blockBytes;
+    std::size_t currentBlock;
+    std::size_t offset;
+    Record* last;
+    std::size_t objects;
+};
+
+#endif // STRATEGY_ARENA_H
@@ -0,0 +1,220 @@
+#include "StrategyCache.h"
+#include "CounterRng.h"
+#include <thread>
+#include <typeinfo>
+
+StrategyCache::StrategyCache(std::size_t capacity) {
+    if (capacity == 0)
+        throw InvestmentException("Cache capacity must be positive");
+    std::size_t setCount = 1;
+    while (setCount * Ways < capacity)
+        setCount *= 2;
+    setMask = setCount - 1;
+    sets.reset(new Set[setCount]);
+    for (std::size_t i = 0; i < setCount; ++i) {
+        sets[i].version.store(0);
+        sets[i].hand = 0;
+        for (std::size_t way = 0; way < Ways; ++way) {
+            sets[i].keys[way].store(0);
+            sets[i].checks[way].store(0);
+            sets[i].values[2 * way].store(0.0);
+            sets[i].values[2 * way + 1].store(0.0);
+            sets[i].referenced[way].store(false);
+        }
+    }
+    counters.reset(new CounterStripe[CounterStripes]);
+    for (std::size_t i = 0; i < CounterStripes; ++i) {
+        counters[i].hits.store(0);
+        counters[i].misses.store(0);
+        counters[i].evictions.store(0);
+    }
+}
+
+// A subclass can share its parent's name and fingerprint while evaluating differently, so both
+// halves also take the dynamic type. The type_info address is unique per type and, unlike
+// hash_code(), costs nothing to read on the hit path.
+ParameterFingerprint StrategyCache::fingerprintFor(const InvestmentStrategy& strategy) {
+    const std::uint64_t type = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&typeid(strategy)));
+    ParameterFingerprint hash;
+    hash.key = CounterRng::mix(strategy.getParameterFingerprint() ^ type);
+    hash.check = strategy.getParameterCheck() + type * 0x9E3779B97F4A7C15ULL;
+    if (hash.key == 0)
+        hash.key = 1;
+    return hash;
+}
+
+// The fingerprint is already well mixed, so its high bits can pick the set directly
+StrategyCache::Set& StrategyCache::setFor(std::uint64_t key) const {
+    return sets[static_cast<std::size_t>(key >> 32) & setMask];
+}
+
+void StrategyCache::lock(Set& set) {
+    for (;;) {
+        std::uint32_t version = set.version.load(std::memory_order_relaxed);
+        if ((version & 1) == 0 &&
+            set.version.compare_exchange_weak(version, version + 1, std::memory_order_acquire))
+            break;
+        std::this_thread::yield();
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void StrategyCache::unlock(Set& set) {
+    set.version.fetch_add(1, std::memory_order_release);
+}
+
+static void bump(std::atomic<std::uint64_t>& counter) {
+    counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+namespace {
+std::atomic<std::size_t> nextStripe(0);
+// Constant-initialized, so reading it needs no thread_local guard
+thread_local std::size_t threadStripe = ~static_cast<std::size_t>(0);
+}
+
+StrategyCache::CounterStripe& StrategyCache::stripe() const {
+    if (threadStripe == ~static_cast<std::size_t>(0))
+        threadStripe = nextStripe.fetch_add(1) % CounterStripes;
+    return counters[threadStripe];
+}
+
+CachedEvaluation StrategyCache::evaluate(const InvestmentStrategy& strategy) {
+    const ParameterFingerprint hash = fingerprintFor(strategy);
+    const std::uint64_t key = hash.key;
+    const std::uint64_t check = hash.check;
+    Set& set = setFor(key);
+
+    // Sequence-lock read: retry if a writer held or changed the set while it was read
+    for (;;) {
+        std::uint32_t before = set.version.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        std::size_t found = Ways;
+        for (std::size_t way = 0; way < Ways; ++way) {
+            if (set.keys[way].load(std::memory_order_relaxed) == key &&
+                set.checks[way].load(std::memory_order_relaxed) == check)
+                found = way;
+        }
+        CachedEvaluation value;
+        if (found != Ways) {
+            value.risk = set.values[2 * found].load(std::memory_order_relaxed);
+            value.returnPerUnit = set.values[2 * found + 1].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (set.version.load(std::memory_order_relaxed) != before)
+            continue;
+        if (found == Ways)
+            break;
+        if (!set.referenced[found].load(std::memory_order_relaxed))
+            set.referenced[found].store(true, std::memory_order_relaxed);
+        bump(stripe().hits);
+        return value;
+    }
+
+    bump(stripe().misses);
+    // Computed before locking; a racing miss on the same key finds it already stored
+    CachedEvaluation value;
+    value.risk = strategy.calculateRisk();
+    value.returnPerUnit = strategy.calculatePotentialReturn(1.0);
+
+    lock(set);
+    // A colliding configuration already under this key is replaced in place
+    std::size_t way = Ways;
+    bool present = false;
+    for (std::size_t i = 0; i < Ways; ++i) {
+        if (set.keys[i].load(std::memory_order_relaxed) == key) {
+            way = i;
+            present = set.checks[i].load(std::memory_order_relaxed) == check;
+        }
+    }
+    if (way == Ways) {
+        // CLOCK: clear reference bits until an empty or unreferenced way comes round
+        for (;;) {
+            way = set.hand;
+            set.hand = static_cast<std::uint32_t>((set.hand + 1) % Ways);
+            if (set.keys[way].load(std::memory_order_relaxed) == 0 ||
+                !set.referenced[way].load(std::memory_order_relaxed))
+                break;
+            set.referenced[way].store(false, std::memory_order_relaxed);
+        }
+        if (set.keys[way].load(std::memory_order_relaxed) != 0)
+            bump(stripe().evictions);
+    }
+    if (!present) {
+        set.keys[way].store(key, std::memory_order_relaxed);
+        set.checks[way].store(check, std::memory_order_relaxed);
+        set.values[2 * way].store(value.risk, std::memory_order_relaxed);
+        set.values[2 * way + 1].store(value.returnPerUnit, std::memory_order_relaxed);
+        set.referenced[way].store(false, std::memory_order_relaxed);
+    }
+    unlock(set);
+    return value;
+}
+
+double StrategyCache::calculateRisk(const InvestmentStrategy& strategy) {
+    return evaluate(strategy).risk;
+}
+
+double StrategyCache::calculatePotentialReturn(const InvestmentStrategy& strategy, double amount) {
+    if (amount <= 0)
+        throw InvestmentException("Investment amount must be positive");
+    return amount * evaluate(strategy).returnPerUnit;
+}
+
+void StrategyCache::invalidate(const InvestmentStrategy& strategy) {
+    const ParameterFingerprint hash = fingerprintFor(strategy);
+    const std::uint64_t key = hash.key;
+    const std::uint64_t check = hash.check;
+    Set& set = setFor(key);
+    lock(set);
+    for (std::size_t way = 0; way < Ways; ++way) {
+        if (set.keys[way].load(std::memory_order_relaxed) == key &&
+            set.checks[way].load(std::memory_order_relaxed) == check)
+            set.keys[way].store(0, std::memory_order_relaxed);
+    }
+    unlock(set);
+}
+
+void StrategyCache::clear() {
+    for (std::size_t i = 0; i <= setMask; ++i) {
+        lock(sets[i]);
+        for (std::size_t way = 0; way < Ways; ++way)
+            sets[i].keys[way].store(0, std::memory_order_relaxed);
+        unlock(sets[i]);
+    }
+}
+
+std::size_t StrategyCache::size() const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i <= setMask; ++i) {
+        for (std::size_t way = 0; way < Ways; ++way)
+            total += sets[i].keys[way].load(std::memory_order_relaxed) != 0 ? 1 : 0;
+    }
+    return total;
+}
+
+std::size_t StrategyCache::capacity() const {
+    return (setMask + 1) * Ways;
+}
+
+std::uint64_t StrategyCache::sumCounter(std::atomic<std::uint64_t> CounterStripe::*counter) const {
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < CounterStripes; ++i)
+        total += (counters[i].*counter).load(std::memory_order_relaxed);
+    return total;
+}
+
+std::uint64_t StrategyCache::hits() const {
+    return sumCounter(&CounterStripe::hits);
+}
+
+std::uint64_t StrategyCache::misses() const {
+    return sumCounter(&CounterStripe::misses);
+}
+
+std::uint64_t StrategyCache::evictions() const {
+    return sumCounter(&CounterStripe::evictions);
+}
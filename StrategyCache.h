@@ -0,0 +1,85 @@
+#ifndef STRATEGY_CACHE_H
+#define STRATEGY_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "InvestmentSimulator.h"
+
+// Amount-independent results of one strategy configuration
+struct CachedEvaluation {
+    double risk;
+    double returnPerUnit;      // calculatePotentialReturn is linear in the amount
+};
+
+// Bounded, concurrent cache of calculateRisk / calculatePotentialReturn keyed on the strategy's
+// parameter fingerprint and dynamic type. The cache is sharded into small sets of eight entries,
+// each with its own sequence lock: lookups read without locking and retry if a writer raced them;
+// misses lock one set and evict within it by the CLOCK algorithm. Setters change the fingerprint,
+// so a modified strategy misses instead of reading a stale entry. Each entry also keeps the
+// strategy's independent parameter check and a hit must match both, so a fingerprint collision
+// misses rather than returning another configuration's results. Potential returns agree with the
+// direct call up to rounding.
+//
+// The built-in strategies compute risk and return in a few arithmetic operations, and calling
+// them directly is two to three times faster than a lookup. The cache pays off for strategies whose
+// evaluation is costlier, such as subclasses that simulate or read market data, when many
+// positions share a configuration.
+class StrategyCache {
+public:
+    explicit StrategyCache(std::size_t capacity = 4096);
+
+    StrategyCache(const StrategyCache&) = delete;
+    StrategyCache& operator=(const StrategyCache&) = delete;
+
+    CachedEvaluation evaluate(const InvestmentStrategy& strategy);
+    double calculateRisk(const InvestmentStrategy& strategy);
+    double calculatePotentialReturn(const InvestmentStrategy& strategy, double amount);
+
+    // Drops the entry for the strategy's current configuration, if cached
+    void invalidate(const InvestmentStrategy& strategy);
+    void clear();
+
+    std::size_t size() const;
+    std::size_t capacity() const;
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+    std::uint64_t evictions() const;
+
+private:
+    static const std::size_t Ways = 8;
+    static const std::size_t CounterStripes = 16;
+
+    // Key 0 marks an empty way
+    struct Set {
+        std::atomic<std::uint32_t> version;     // odd while a writer holds the set
+        std::uint32_t hand;
+        std::atomic<std::uint64_t> keys[Ways];
+        std::atomic<std::uint64_t> checks[Ways];
+        std::atomic<double> values[Ways * 2];    // risk and returnPerUnit side by side, one line per hit
+        std::atomic<bool> referenced[Ways];
+    };
+
+    // Counters are striped by thread and padded to a cache line, so a relaxed fetch_add rarely
+    // contends; threads that share a stripe still count exactly.
+    struct CounterStripe {
+        std::atomic<std::uint64_t> hits;
+        std::atomic<std::uint64_t> misses;
+        std::atomic<std::uint64_t> evictions;
+        char padding[64 - 3 * sizeof(std::atomic<std::uint64_t>)];
+    };
+
+    static ParameterFingerprint fingerprintFor(const InvestmentStrategy& strategy);
+    Set& setFor(std::uint64_t key) const;
+    static void lock(Set& set);
+    static void unlock(Set& set);
+    CounterStripe& stripe() const;
+    std::uint64_t sumCounter(std::atomic<std::uint64_t> CounterStripe::*counter) const;
+
+    std::unique_ptr<Set[]> sets;
+    std::size_t setMask;
+    std::unique_ptr<CounterStripe[]> counters;
+};
+
+#endif // STRATEGY_CACHE_H
@@ -0,0 +1,43 @@
+#ifndef STRATEGY_FORMULAS_H
+#define STRATEGY_FORMULAS_H
+
+#include <cmath>
+
+// The Stock and Bond pricing formulas, templated on the number type. StockInvestment,
+// BondInvestment, the compile-time kernels and the portfolio loops instantiate them with double;
+// Sensitivity.h instantiates them with Dual to get parameter derivatives from the same
+// expressions. Branches compare values, so derivatives follow whichever side of a branch the
+// parameters select. The stock formulas are single expressions so StockModel can stay constexpr.
+
+template <typename T>
+constexpr T stockRisk(const T& riskRating, const T& volatilityFactor) {
+    return riskRating * 1.5 + volatilityFactor;
+}
+
+// risk is taken rather than derived, so a StockInvestment subclass overriding calculateRisk()
+// invests with its own risk
+template <typename T>
+constexpr T stockInvestValue(const T& amount, const T& risk, const T& expectedReturn, const T& volatilityFactor,
+                             const T& dividendYield) {
+    return amount + amount * expectedReturn * (1.0 + risk) + amount * dividendYield + amount * volatilityFactor * 0.05;
+}
+
+template <typename T>
+T bondEffectiveRate(const T& interestRate, const T& inflationRate, bool callable, const T& callableAdjustment,
+                    const T& inflationAdjustment) {
+    T effectiveRate = interestRate;
+    if (callable)
+        effectiveRate = effectiveRate * callableAdjustment;
+    if (effectiveRate > inflationRate)
+        effectiveRate = effectiveRate - inflationRate * inflationAdjustment;
+    return effectiveRate;
+}
+
+// termYears is a T so sensitivities can treat the term as continuous
+template <typename T>
+T bondGrowthFactor(const T& effectiveRate, const T& termYears) {
+    using std::pow;
+    return pow(1.0 + effectiveRate, termYears);
+}
+
+#endif // STRATEGY_FORMULAS_H
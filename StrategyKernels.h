@@ -0,0 +1,245 @@
+#ifndef STRATEGY_KERNELS_H
+#define STRATEGY_KERNELS_H
+
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include "InvestmentSimulator.h"
+#include "StrategyFormulas.h"
+
+// Header-only, statically dispatched versions of the Stock and Bond formulas.
+// Every formula is constexpr, so models built from constant parameters fold at compile time.
+// value() skips validation; invest() and investBatch() validate like the virtual classes.
+
+// (base)^exponent by recursive squaring, usable in constant expressions
+constexpr double kernelPower(double base, int exponent) {
+    return exponent == 0 ? 1.0
+         : exponent % 2 != 0 ? base * kernelPower(base * base, exponent / 2)
+         : kernelPower(base * base, exponent / 2);
+}
+
+// CRTP base: batch loops call Derived::value directly, so it can be inlined
+template <typename Derived>
+struct StrategyKernel {
+    double invest(double amount) const {
+        if (amount <= 0)
+            throw InvestmentException("Investment amount must be positive");
+        return self().value(amount);
+    }
+
+    void investBatch(const double* amounts, double* out, std::size_t n) const {
+        if (n == 0)
+            return;
+        if (!amounts || !out)
+            throw InvestmentException("Batch buffers cannot be null");
+        bool invalid = false;
+        for (std::size_t i = 0; i < n; ++i)
+            invalid |= (amounts[i] <= 0);
+        if (invalid)
+            throw InvestmentException("Investment amount must be positive");
+        const Derived& model = self();
+        for (std::size_t i = 0; i < n; ++i)
+            out[i] = model.value(amounts[i]);
+    }
+
+private:
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+struct StockModel : StrategyKernel<StockModel> {
+    double riskRating;
+    double expectedReturn;
+    double volatilityFactor;
+    double dividendYield;
+
+    constexpr StockModel(double risk = 0.5, double returnRate = 0.12, double volatility = 0.2, double divYield = 0.03)
+        : riskRating(risk), expectedReturn(returnRate), volatilityFactor(volatility), dividendYield(divYield) {}
+
+    static StockModel from(const StockInvestment& stock) {
+        return StockModel(stock.getRiskRating(), stock.getExpectedReturn(),
+                          stock.getVolatilityFactor(), stock.getDividendYield());
+    }
+
+    constexpr double risk() const {
+        return stockRisk(riskRating, volatilityFactor);
+    }
+    constexpr double value(double amount) const {
+        return stockInvestValue(amount, risk(), expectedReturn, volatilityFactor, dividendYield);
+    }
+    constexpr double potentialReturn(double amount) const {
+        return amount * (expectedReturn + dividendYield + volatilityFactor * 0.05);
+    }
+};
+
+// Call policies fix the callable branch at compile time, or read it from the model
+struct CallableFromField { static constexpr bool apply(bool field) { return field; } };
+struct AlwaysCallable { static constexpr bool apply(bool) { return true; } };
+struct NeverCallable { static constexpr bool apply(bool) { return false; } };
+
+// Compounds with kernelPower rather than std::pow, so results agree with
+// BondInvestment to rounding error rather than bit for bit.
+template <typename CallPolicy = CallableFromField>
+struct BondModel : StrategyKernel<BondModel<CallPolicy> > {
+    double interestRate;
+    int termYears;
+    double inflationRate;
+    bool callable;
+    double callableAdjustment;
+    double baseRiskWeight;
+    double inflationAdjustment;
+    double riskRating;
+
+    constexpr BondModel(double rate = 0.05, int years = 5, double inflation = 0.02, bool isCallable = false,
+                        double callableAdj = 0.9, double riskWeight = 0.8, double inflationAdj = 1.0,
+                        double risk = 0.2)
+        : interestRate(rate), termYears(years), inflationRate(inflation), callable(isCallable),
+          callableAdjustment(callableAdj), baseRiskWeight(riskWeight), inflationAdjustment(inflationAdj),
+          riskRating(risk) {}
+
+    static BondModel from(const BondInvestment& bond) {
+        return BondModel(bond.getInterestRate(), bond.getTermYears(), bond.getInflationRate(), bond.isCallable(),
+                         bond.getCallableAdjustment(), bond.getBaseRiskWeight(), bond.getInflationAdjustment(),
+                         bond.getRiskRating());
+    }
+
+    constexpr bool isCallable() const {
+        return CallPolicy::apply(callable);
+    }
+    constexpr double adjustedRate() const {
+        return isCallable() ? interestRate * callableAdjustment : interestRate;
+    }
+    constexpr double effectiveRate() const {
+        return adjustedRate() > inflationRate ? adjustedRate() - inflationRate * inflationAdjustment : adjustedRate();
+    }
+    constexpr double risk() const {
+        return baseRiskWeight * riskRating + (isCallable() ? 0.1 : 0.0) + inflationRate * inflationAdjustment;
+    }
+    constexpr double value(double amount) const {
+        return amount * kernelPower(1.0 + effectiveRate(), termYears);
+    }
+    constexpr double potentialReturn(double amount) const {
+        return amount * effectiveRate() * termYears;
+    }
+};
+
+// Closed set of kernels held by value; dispatch is a switch instead of a virtual call
+class StrategyVariant {
+public:
+    enum Kind { None, Stock, Bond };
+
+    StrategyVariant() : kind(None), stock() {}
+    StrategyVariant(const StockModel& model) : kind(Stock), stock(model) {}
+    StrategyVariant(const BondModel<>& model) : kind(Bond), bond(model) {}
+
+    Kind type() const { return kind; }
+
+    // Calls visitor(model) with the held model; the variant must not be empty
+    template <typename Visitor>
+    auto visit(Visitor&& visitor) const -> decltype(visitor(std::declval<const StockModel&>())) {
+        switch (kind) {
+        case Stock:
+            return visitor(stock);
+        case Bond:
+            return visitor(bond);
+        default:
+            throw InvestmentException("No investment strategy set");
+        }
+    }
+
+    double invest(double amount) const {
+        switch (kind) {
+        case Stock:
+            return stock.invest(amount);
+        case Bond:
+            return bond.invest(amount);
+        default:
+            throw InvestmentException("No investment strategy set");
+        }
+    }
+    double calculatePotentialReturn(double amount) const {
+        if (amount <= 0)
+            throw InvestmentException("Investment amount must be positive");
+        switch (kind) {
+        case Stock:
+            return stock.potentialReturn(amount);
+        case Bond:
+            return bond.potentialReturn(amount);
+        default:
+            throw InvestmentException("No investment strategy set");
+        }
+    }
+    double calculateRisk() const {
+        switch (kind) {
+        case Stock:
+            return stock.risk();
+        case Bond:
+            return bond.risk();
+        default:
+            throw InvestmentException("No investment strategy set");
+        }
+    }
+    std::string getStrategyName() const {
+        return kind == Stock ? "Stock" : kind == Bond ? "Bond" : "No strategy set";
+    }
+
+private:
+    Kind kind;
+    union {
+        StockModel stock;
+        BondModel<> bond;
+    };
+};
+
+// Single-threaded counterpart of Bank that holds its strategy by value
+class VariantBank {
+public:
+    VariantBank(const std::string& bankName, double initialFunds = 0.0)
+        : name(bankName), availableFunds(initialFunds) {
+        if (initialFunds < 0.0)
+            throw InvestmentException("Initial funds cannot be negative");
+    }
+
+    void setStrategy(const StrategyVariant& newStrategy) {
+        if (newStrategy.type() == StrategyVariant::None)
+            throw InvestmentException("Strategy cannot be null");
+        strategy = newStrategy;
+    }
+
+    double executeInvestment(double amount) {
+        if (strategy.type() == StrategyVariant::None)
+            throw InvestmentException("No investment strategy set");
+        if (amount > availableFunds)
+            throw InvestmentException("Insufficient funds for investment");
+        double result = strategy.invest(amount);
+        availableFunds -= amount;
+        return result;
+    }
+
+    void depositFunds(double amount) {
+        if (amount <= 0)
+            throw InvestmentException("Deposit amount must be positive");
+        availableFunds += amount;
+    }
+
+    bool withdrawFunds(double amount) {
+        if (amount <= 0)
+            throw InvestmentException("Withdrawal amount must be positive");
+        if (amount > availableFunds)
+            return false;
+        availableFunds -= amount;
+        return true;
+    }
+
+    const StrategyVariant& getStrategy() const { return strategy; }
+    std::string getCurrentStrategyName() const { return strategy.getStrategyName(); }
+    std::string getName() const { return name; }
+    double getAvailableFunds() const { return availableFunds; }
+
+private:
+    std::string name;
+    double availableFunds;
+    StrategyVariant strategy;
+};
+
+#endif // STRATEGY_KERNELS_H
@@ -0,0 +1,105 @@
+#ifndef STRATEGY_RECORD_H
+#define STRATEGY_RECORD_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include "InvestmentSimulator.h"
+
+// The strategy encoding shared by the journal (JournalStrategy) and the bank snapshot
+// (BankSnapshotStrategy). Each record has kind, callable, termYears, riskRating and params fields
+// and stores the name its own way; these templates fill and read those fields for either format.
+//   Stock params:  expectedReturn, volatilityFactor, dividendYield
+//   Bond params:   interestRate, inflationRate, callableAdjustment, baseRiskWeight, inflationAdjustment
+//   Crypto params: volatility, hypeFactor, jumpIntensity, jumpMean, jumpVolatility
+// The name is the strategy name for the base kind, the coin name for crypto and empty otherwise.
+// Only the four exact types can be recorded; a subclass would come back as its parent, so
+// encoding one throws.
+
+enum StrategyRecordKind : std::uint8_t {
+    StrategyRecordBase = 0,
+    StrategyRecordStock = 1,
+    StrategyRecordBond = 2,
+    StrategyRecordCrypto = 3
+};
+
+// Fills the strategy fields of a zeroed record and returns the name through name
+template <typename Record>
+void encodeStrategyRecord(const InvestmentStrategy& strategy, Record& record, std::string& name) {
+    record.riskRating = strategy.getRiskRating();
+    name.clear();
+    const std::type_info& type = typeid(strategy);
+    if (type == typeid(StockInvestment)) {
+        const StockInvestment& stock = static_cast<const StockInvestment&>(strategy);
+        record.kind = StrategyRecordStock;
+        record.params[0] = stock.getExpectedReturn();
+        record.params[1] = stock.getVolatilityFactor();
+        record.params[2] = stock.getDividendYield();
+    } else if (type == typeid(BondInvestment)) {
+        const BondInvestment& bond = static_cast<const BondInvestment&>(strategy);
+        record.kind = StrategyRecordBond;
+        record.callable = bond.isCallable() ? 1 : 0;
+        record.termYears = bond.getTermYears();
+        record.params[0] = bond.getInterestRate();
+        record.params[1] = bond.getInflationRate();
+        record.params[2] = bond.getCallableAdjustment();
+        record.params[3] = bond.getBaseRiskWeight();
+        record.params[4] = bond.getInflationAdjustment();
+    } else if (type == typeid(CryptoInvestment)) {
+        const CryptoInvestment& crypto = static_cast<const CryptoInvestment&>(strategy);
+        record.kind = StrategyRecordCrypto;
+        name = crypto.getCryptoName();
+        record.params[0] = crypto.getCryptoVolatility();
+        record.params[1] = crypto.getHypeFactor();
+        record.params[2] = crypto.getJumpIntensity();
+        record.params[3] = crypto.getJumpMean();
+        record.params[4] = crypto.getJumpVolatility();
+    } else if (type == typeid(InvestmentStrategy)) {
+        record.kind = StrategyRecordBase;
+        name = strategy.getStrategyName();
+    } else {
+        throw InvestmentException("Cannot record a strategy of a custom type: " + strategy.getStrategyName());
+    }
+}
+
+// One decoder per kind, for callers that keep each concrete type in its own array. The
+// constructors validate the parameters.
+template <typename Record>
+StockInvestment decodeStockRecord(const Record& record) {
+    return StockInvestment(record.riskRating, record.params[0], record.params[1], record.params[2]);
+}
+
+template <typename Record>
+BondInvestment decodeBondRecord(const Record& record) {
+    BondInvestment bond(record.params[0], record.termYears, record.params[1], record.callable != 0,
+                        record.params[2], record.params[3], record.params[4]);
+    bond.setRiskRating(record.riskRating);
+    return bond;
+}
+
+template <typename Record>
+CryptoInvestment decodeCryptoRecord(const Record& record, const std::string& name) {
+    CryptoInvestment crypto(name, record.params[0], record.params[1], record.params[2], record.params[3],
+                            record.params[4]);
+    crypto.setRiskRating(record.riskRating);
+    return crypto;
+}
+
+template <typename Record>
+std::shared_ptr<InvestmentStrategy> decodeStrategyRecord(const Record& record, const std::string& name) {
+    switch (record.kind) {
+    case StrategyRecordStock:
+        return std::make_shared<StockInvestment>(decodeStockRecord(record));
+    case StrategyRecordBond:
+        return std::make_shared<BondInvestment>(decodeBondRecord(record));
+    case StrategyRecordCrypto:
+        return std::make_shared<CryptoInvestment>(decodeCryptoRecord(record, name));
+    case StrategyRecordBase:
+        return std::make_shared<InvestmentStrategy>(name, record.riskRating);
+    default:
+        throw InvestmentException("Unknown strategy record kind");
+    }
+}
+
+#endif // STRATEGY_RECORD_H
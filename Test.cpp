@@ -2,7 +2,52 @@
 #include <fstream>
 #include <memory>
 #include <cassert>
-#include "InvestmentSimulator.h"  // Assumes StockInvestment, BondInvestment, CryptoInvestment, and Bank are declared here
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstdio>
+#include "InvestmentSimulator.h"
+#include "ThreadPool.h"
+#include "Portfolio.h"
+#include "ScenarioGrid.h"
+#include "DetailFormat.h"
+#include "StrategyKernels.h"
+#include "PositionFile.h"
+#include "PeriodSimulation.h"
+#include "RebalancingBank.h"
+#include "StrategyCache.h"
+#include "Metrics.h"
+#include "StrategyArena.h"
+#include "JournaledBank.h"
+#include "InvestmentPipeline.h"
+#include "RiskAggregator.h"
+#include "BankCluster.h"
+#include "Sensitivity.h"
+#include "StrategyFormulas.h"
+#include "BankSnapshot.h"
+#include "YieldCurve.h"
+#ifndef _WIN32
+#include <csignal>
+#include <sys/resource.h>
+#endif
+#include <sstream>  // Assumes StockInvestment, BondInvestment, CryptoInvestment, and Bank are declared here
+
+// Kernels built from constants must evaluate at compile time
+constexpr StockModel constantStock(0.5, 0.15, 0.2, 0.03);
+static_assert(constantStock.value(1000.0) > 1000.0, "StockModel should fold to a constant");
+constexpr BondModel<AlwaysCallable> constantBond(0.06, 7, 0.025);
+static_assert(constantBond.value(1000.0) > 1000.0, "BondModel should fold to a constant");
+
+// Uncached bond formula, used to check the cached fast path
+static double referenceBondValue(const BondInvestment& bond, double amount) {
+    double effectiveRate = bond.getInterestRate();
+    if (bond.isCallable())
+        effectiveRate *= bond.getCallableAdjustment();
+    if (effectiveRate > bond.getInflationRate())
+        effectiveRate -= bond.getInflationRate() * bond.getInflationAdjustment();
+    return amount * std::pow(1.0 + effectiveRate, bond.getTermYears());
+}
 
 int main() {
     std::ofstream testFile("test.txt");
@@ -94,6 +139,1631 @@ int main() {
         assert(false);
     }
 
+    // Batch Investment Tests
+    try {
+        std::vector<double> amounts;
+        for (int i = 1; i <= 37; ++i)
+            amounts.push_back(amount * i * 0.37);
+        std::vector<double> out(amounts.size());
+
+        StockInvestment stock(0.5, 0.15, 0.2, 0.03);
+        stock.investBatch(amounts.data(), out.data(), amounts.size());
+        for (size_t i = 0; i < amounts.size(); ++i)
+            assert(out[i] == stock.invest(amounts[i]));
+        testFile << "StockInvestment investBatch matches invest PASSED\n";
+
+        struct CappedRiskStock : StockInvestment {
+            CappedRiskStock() : StockInvestment(0.5, 0.15, 0.2, 0.03) {}
+            double calculateRisk() const override { return 0.1; }
+        };
+        CappedRiskStock capped;
+        capped.investBatch(amounts.data(), out.data(), amounts.size());
+        for (size_t i = 0; i < amounts.size(); ++i)
+            assert(out[i] == capped.invest(amounts[i]));
+        assert(capped.invest(amount) != stock.invest(amount));
+        testFile << "StockInvestment invest uses an overridden calculateRisk PASSED\n";
+
+        BondInvestment bond(0.05, 5, 0.02, true);
+        const InvestmentStrategy& base = bond;
+        base.investBatch(amounts.data(), out.data(), amounts.size());
+        for (size_t i = 0; i < amounts.size(); ++i)
+            assert(out[i] == bond.invest(amounts[i]));
+        testFile << "BondInvestment investBatch matches invest PASSED\n";
+
+        amounts[20] = -1.0;
+        bool thrown = false;
+        try {
+            stock.investBatch(amounts.data(), out.data(), amounts.size());
+        } catch (const InvestmentException&) {
+            thrown = true;
+        }
+        assert(thrown);
+        testFile << "investBatch rejects non-positive amount PASSED\n";
+
+        struct DoublingStrategy : InvestmentStrategy {
+            DoublingStrategy() : InvestmentStrategy("Doubling", 0.2) {}
+            double invest(double value) const override { return value * 2.0; }
+        };
+        struct DoublingStock : StockInvestment {
+            InvestmentResult tryInvest(double value) const override {
+                return InvestmentResult::success(value * 2.0);
+            }
+        };
+        const double pair[] = { 10.0, 30.0 };
+        double valued[2];
+        DoublingStrategy().investBatch(pair, valued, 2);
+        assert(valued[0] == 20.0 && valued[1] == 60.0);
+        DoublingStock().investBatch(pair, valued, 2);
+        assert(valued[0] == 20.0 && valued[1] == 60.0);
+        const double missing[] = { 10.0, std::nan("") };
+        thrown = false;
+        try {
+            DoublingStrategy().investBatch(missing, valued, 2);
+        } catch (const InvestmentException&) {
+            thrown = true;
+        }
+        assert(thrown);
+        testFile << "investBatch values through overridden invest and tryInvest PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Batch Investment Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Monte Carlo Tests
+    try {
+        StockInvestment stock(0.5, 0.08, 0.2, 0.02);
+        MonteCarloSettings settings(20000, 12, 1.0, 0.95, 7);
+
+        ThreadPool single(1);
+        ThreadPool several(4);
+        MonteCarloResult a = stock.simulate(amount, settings, single);
+        MonteCarloResult b = stock.simulate(amount, settings, several);
+        assert(a.mean == b.mean && a.percentile5 == b.percentile5 && a.valueAtRisk == b.valueAtRisk);
+        testFile << "StockInvestment simulate reproducible across thread counts PASSED\n";
+
+        double expectedMean = amount * std::exp(0.08 + 0.02);
+        assert(std::abs(a.mean - expectedMean) < expectedMean * 0.01);
+        assert(a.percentile5 < a.percentile50 && a.percentile50 < a.percentile95);
+        assert(a.valueAtRisk == amount - a.percentile5);
+        testFile << "StockInvestment simulate mean/percentiles/VaR PASSED\n";
+
+        StockInvestment riskless(0.5, 0.05, 0.0, 0.0);
+        MonteCarloResult flat = riskless.simulate(amount, settings, several);
+        assert(std::abs(flat.percentile5 - flat.percentile95) < 1e-9);
+        assert(flat.standardDeviation < 1e-9);
+        testFile << "StockInvestment simulate zero volatility is deterministic PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Monte Carlo Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Portfolio Tests
+    try {
+        std::vector<std::shared_ptr<InvestmentStrategy> > objects;
+        std::vector<double> amounts;
+        Portfolio portfolio;
+        for (int i = 0; i < 50; ++i) {
+            double positionAmount = 500.0 + 37.0 * i;
+            auto stock = std::make_shared<StockInvestment>(0.1 + 0.01 * i, 0.05 + 0.002 * i, 0.1 + 0.003 * i, 0.01);
+            auto bond = std::make_shared<BondInvestment>(0.02 + 0.001 * i, 1 + i % 10, 0.01 + 0.0005 * i, i % 2 == 0);
+            portfolio.addStock(*stock, positionAmount);
+            portfolio.addBond(*bond, positionAmount);
+            objects.push_back(stock);
+            objects.push_back(bond);
+            amounts.push_back(positionAmount);
+        }
+        assert(portfolio.size() == 100 && portfolio.stockCount() == 50);
+
+        PortfolioValuation valuation = portfolio.evaluate();
+        double totalValue = 0.0;
+        for (size_t i = 0; i < amounts.size(); ++i) {
+            const InvestmentStrategy& stock = *objects[2 * i];
+            const InvestmentStrategy& bond = *objects[2 * i + 1];
+            assert(valuation.stockValues[i] == stock.invest(amounts[i]));
+            assert(valuation.stockReturns[i] == stock.calculatePotentialReturn(amounts[i]));
+            assert(valuation.stockRisks[i] == stock.calculateRisk());
+            assert(valuation.bondValues[i] == bond.invest(amounts[i]));
+            assert(valuation.bondReturns[i] == bond.calculatePotentialReturn(amounts[i]));
+            assert(valuation.bondRisks[i] == bond.calculateRisk());
+            totalValue += stock.invest(amounts[i]) + bond.invest(amounts[i]);
+        }
+        assert(std::abs(valuation.totalValue - totalValue) < 1e-6);
+        testFile << "Portfolio evaluate matches strategy objects PASSED\n";
+
+        bool thrown = false;
+        try {
+            portfolio.addStock(StockInvestment(), 0.0);
+        } catch (const InvestmentException&) {
+            thrown = true;
+        }
+        assert(thrown && portfolio.stockCount() == 50);
+        testFile << "Portfolio rejects non-positive amount PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Portfolio Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Bond Growth Cache Tests
+    try {
+        BondInvestment bond(0.05, 5, 0.02, true);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setInterestRate(0.07);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setTermYears(12);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setInflationRate(0.09);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setCallable(false);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setCallableAdjustment(0.5);
+        bond.setCallable(true);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setInflationAdjustment(0.3);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        bond.setTerms(0.04, 9, 0.01, false);
+        assert(bond.invest(amount) == referenceBondValue(bond, amount));
+        testFile << "BondInvestment cached growth invalidated by setters PASSED\n";
+
+        std::vector<double> table = bond.growthTable(30);
+        for (int year = 1; year <= 30; ++year) {
+            double exact = std::pow(1.0 + bond.getEffectiveRate(), year);
+            assert(std::abs(table[year - 1] - exact) <= exact * 1e-13);
+            assert(std::abs(BondInvestment::integerPower(1.0 + bond.getEffectiveRate(), year) - exact) <= exact * 1e-13);
+        }
+        assert(std::abs(table[bond.getTermYears() - 1] * amount - bond.invest(amount)) <= 1e-9);
+        testFile << "BondInvestment growthTable/integerPower within tolerance PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Bond Growth Cache Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Scenario Grid Tests
+    try {
+        std::vector<ParameterRange> bondRanges;
+        bondRanges.push_back(ParameterRange(0.01, 0.10, 10));
+        bondRanges.push_back(ParameterRange(1.0, 30.0, 30));
+        bondRanges.push_back(ParameterRange(0.0, 0.05, 6));
+        bondRanges.push_back(ParameterRange(0.0, 1.0, 2));
+        ScenarioGrid grid(bondRanges);
+        assert(grid.size() == 10 * 30 * 6 * 2);
+
+        double point[4];
+        grid.point(grid.size() - 1, point);
+        assert(point[0] == 0.10 && point[1] == 30.0 && point[2] == 0.05 && point[3] == 1.0);
+
+        size_t positions[4];
+        double walked[4];
+        grid.seek(0, positions, walked);
+        for (size_t index = 1; index < grid.size(); ++index) {
+            grid.advance(positions, walked);
+            grid.point(index, point);
+            assert(std::equal(point, point + 4, walked));
+        }
+        testFile << "ScenarioGrid advance matches point decoding PASSED\n";
+
+        BondInvestment base;
+        ThreadPool several(4);
+        std::vector<double> values(grid.size(), -1.0);
+        ScenarioRunner(several, 97).runBonds(grid, base, amount, [&](const ScenarioResult* results, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                assert(values[results[i].index] < 0.0);
+                values[results[i].index] = results[i].value;
+            }
+        });
+        for (size_t index = 0; index < grid.size(); index += 37) {
+            grid.point(index, point);
+            BondInvestment expected(point[0], static_cast<int>(point[1] + 0.5), point[2], point[3] > 0.5);
+            assert(values[index] == expected.invest(amount));
+        }
+        testFile << "ScenarioRunner bond grid covers every point once PASSED\n";
+
+        std::shared_ptr<YieldCurve> scenarioCurve = std::make_shared<YieldCurve>(std::vector<double>{1.0, 10.0},
+                                                                                 std::vector<double>{0.02, 0.04}, 30);
+        BondInvestment curveBase;
+        curveBase.setYieldCurve(scenarioCurve);
+        std::vector<ParameterRange> smallRanges;
+        smallRanges.push_back(ParameterRange(0.03, 0.05, 3));
+        smallRanges.push_back(ParameterRange(2.0, 4.0, 3));
+        smallRanges.push_back(ParameterRange(0.01));
+        smallRanges.push_back(ParameterRange(0.0, 1.0, 2));
+        ScenarioGrid smallGrid(smallRanges);
+        std::vector<double> curveValues(smallGrid.size(), -1.0);
+        ScenarioRunner(several, 4).runBonds(smallGrid, curveBase, amount, [&](const ScenarioResult* results, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                curveValues[results[i].index] = results[i].value;
+        });
+        for (size_t index = 0; index < smallGrid.size(); ++index) {
+            smallGrid.point(index, point);
+            BondInvestment expected(point[0], static_cast<int>(point[1] + 0.5), point[2], point[3] > 0.5);
+            assert(curveValues[index] == expected.invest(amount));
+        }
+        assert(curveBase.getYieldCurve() == scenarioCurve && scenarioCurve->dependentCount() == 1);
+        testFile << "ScenarioRunner evaluates a curve-attached bond at the grid rates PASSED\n";
+
+        std::vector<ParameterRange> stockRanges;
+        stockRanges.push_back(ParameterRange(0.05, 0.15, 11));
+        stockRanges.push_back(ParameterRange(0.1, 0.4, 7));
+        stockRanges.push_back(ParameterRange(0.02));
+        ScenarioGrid stockGrid(stockRanges);
+        double parallelTotal = 0.0;
+        double serialTotal = 0.0;
+        size_t seen = 0;
+        ScenarioRunner(several, 5).runStocks(stockGrid, StockInvestment(), amount, [&](const ScenarioResult* results, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                parallelTotal += results[i].risk;
+            seen += count;
+        });
+        ThreadPool single(1);
+        ScenarioRunner(single).runStocks(stockGrid, StockInvestment(), amount, [&](const ScenarioResult* results, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                serialTotal += results[i].risk;
+        });
+        assert(seen == stockGrid.size() && std::abs(parallelTotal - serialTotal) < 1e-9);
+        testFile << "ScenarioRunner stock grid matches single-threaded run PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Scenario Grid Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Detail Formatting Tests
+    try {
+        const double samples[] = {0.0, 1.0, -7.0, 2000.0, 999999.0, 1000000.0, 12345678.0, 0.5, 0.025, 2.5,
+                                  1234.5678, 1e-7, -3.25, 6.0000001, 1e300, 999999.7, 99999.95, 0.0001,
+                                  0.00009999996, 1.0000005, 14999.75, 0.15 * 100, 0.07 * 100, 123456.5};
+        for (double sample : samples) {
+            std::stringstream expected;
+            expected << sample;
+            std::string actual;
+            appendNumber(actual, sample);
+            assert(actual == expected.str());
+        }
+        unsigned long long state = 12345;
+        for (int i = 0; i < 200000; ++i) {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            double mantissa = static_cast<double>(state >> 11) / 9007199254740992.0;
+            int exponent = static_cast<int>((state >> 3) % 16) - 7;
+            double sample = (i % 2 ? -1.0 : 1.0) * mantissa * std::pow(10.0, exponent);
+            if (i % 7 == 0)
+                sample = std::floor(sample * 1000.0 + 0.5) / 1000.0;
+            std::stringstream expected;
+            expected << sample;
+            std::string actual;
+            appendNumber(actual, sample);
+            assert(actual == expected.str());
+        }
+        testFile << "appendNumber matches ostream formatting PASSED\n";
+
+        StockInvestment stock(0.5, 0.15, 0.2, 0.03);
+        std::stringstream stockExpected;
+        stockExpected << "Investing $" << 1234.56 << " using Stock strategy (Risk rating: " << 0.5 << ")";
+        assert(stock.getInvestmentDetails(1234.56) == stockExpected.str());
+
+        BondInvestment bond(0.06, 7, 0.025, true);
+        std::stringstream bondExpected;
+        bondExpected << "Investing $" << 2000.0 << " using Bond strategy (Risk rating: " << 0.2 << ")"
+                     << " with " << 0.06 * 100 << "% nominal interest over " << 7
+                     << " years, Inflation Rate: " << 0.025 * 100 << "%, Callable: Yes"
+                     << ", Callable Adjustment: " << 0.9 << ", Base Risk Weight: " << 0.8
+                     << ", Inflation Adjustment: " << 1.0;
+        assert(bond.getInvestmentDetails(2000.0) == bondExpected.str());
+
+        Bank bank("Format Bank", 15000.0);
+        assert(bank.getDetails() == "Bank: Format Bank\nAvailable Funds: $15000\nCurrent Strategy: No strategy set");
+        bank.setStrategy(std::make_shared<BondInvestment>(bond));
+        bank.executeInvestment(0.25);
+        std::string appended = "prefix|";
+        bank.appendDetails(appended);
+        assert(appended == "prefix|Bank: Format Bank\nAvailable Funds: $14999.8\nCurrent Strategy: Bond");
+        testFile << "Details text unchanged and appendable PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Detail Formatting Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Strategy Kernel Tests
+    try {
+        StockInvestment stock(0.5, 0.15, 0.2, 0.03);
+        StockModel stockModel = StockModel::from(stock);
+        assert(stockModel.invest(amount) == stock.invest(amount));
+        assert(stockModel.potentialReturn(amount) == stock.calculatePotentialReturn(amount));
+        assert(stockModel.risk() == stock.calculateRisk());
+        assert(constantStock.value(amount) == stock.invest(amount));
+        testFile << "StockModel matches StockInvestment PASSED\n";
+
+        for (int callable = 0; callable < 2; ++callable) {
+            BondInvestment bond(0.06, 7, 0.025, callable == 1);
+            BondModel<> bondModel = BondModel<>::from(bond);
+            assert(std::abs(bondModel.invest(amount) - bond.invest(amount)) <= bond.invest(amount) * 1e-14);
+            assert(bondModel.potentialReturn(amount) == bond.calculatePotentialReturn(amount));
+            assert(bondModel.risk() == bond.calculateRisk());
+        }
+        BondInvestment callableBond(0.06, 7, 0.025, true);
+        assert(std::abs(constantBond.value(amount) - callableBond.invest(amount)) <= amount * 1e-13);
+        assert(BondModel<NeverCallable>(0.06, 7, 0.025, true).risk() == BondInvestment(0.06, 7, 0.025, false).calculateRisk());
+        testFile << "BondModel matches BondInvestment PASSED\n";
+
+        std::vector<double> amounts(16, amount);
+        std::vector<double> out(amounts.size());
+        stockModel.investBatch(amounts.data(), out.data(), amounts.size());
+        assert(out[15] == stock.invest(amount));
+        testFile << "StrategyKernel investBatch PASSED\n";
+
+        VariantBank bank("VariantBank", 5000.0);
+        bool thrown = false;
+        try {
+            bank.executeInvestment(100.0);
+        } catch (const InvestmentException&) {
+            thrown = true;
+        }
+        assert(thrown);
+        bank.setStrategy(stockModel);
+        assert(bank.executeInvestment(1000.0) == stock.invest(1000.0));
+        bank.setStrategy(BondModel<>::from(callableBond));
+        assert(bank.getCurrentStrategyName() == "Bond" && bank.getAvailableFunds() == 4000.0);
+        assert(bank.getStrategy().calculateRisk() == callableBond.calculateRisk());
+        thrown = false;
+        try {
+            bank.executeInvestment(4000.5);
+        } catch (const InvestmentException&) {
+            thrown = true;
+        }
+        assert(thrown && bank.getAvailableFunds() == 4000.0);
+        testFile << "VariantBank executes through StrategyVariant PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Strategy Kernel Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Position File Tests
+    try {
+        const char* positionPath = "test_positions.bin";
+        StockInvestment stock(0.5, 0.15, 0.2, 0.03);
+        BondInvestment bond(0.06, 7, 0.025, true);
+        {
+            PositionFileWriter writer(positionPath);
+            for (int i = 0; i < 1000; ++i) {
+                if (i % 3 == 0)
+                    writer.add(bond, amount + i);
+                else
+                    writer.add(stock, amount + i);
+            }
+            std::stringstream csv("type,amount,risk,...\n"
+                                  "# comment\n"
+                                  "stock, 2500, 0.5, 0.15, 0.2, 0.03\n"
+                                  "\n"
+                                  "bond,2500,0.2,0.06,7,0.025,1,0.9,0.8,1.0\n");
+            assert(convertCsvPositions(csv, writer) == 2);
+            assert(writer.count() == 1002);
+        }
+
+        PositionFileReader reader(positionPath);
+        assert(reader.size() == 1002);
+        size_t next = 0;
+        reader.evaluate([&](size_t firstIndex, const PositionValuation* results, size_t count) {
+            assert(firstIndex == next && count <= 128);
+            for (size_t i = 0; i < count; ++i) {
+                size_t index = firstIndex + i;
+                const InvestmentStrategy& expected = index >= 1000 ? (index == 1000 ? static_cast<const InvestmentStrategy&>(stock) : bond)
+                                                                   : (index % 3 == 0 ? static_cast<const InvestmentStrategy&>(bond) : stock);
+                double positionAmount = index >= 1000 ? 2500.0 : amount + index;
+                assert(results[i].value == expected.invest(positionAmount));
+                assert(results[i].potentialReturn == expected.calculatePotentialReturn(positionAmount));
+                assert(results[i].risk == expected.calculateRisk());
+            }
+            next += count;
+        }, 128);
+        assert(next == 1002);
+        testFile << "PositionFile round trip and streaming evaluate PASSED\n";
+
+        std::stringstream badCsv("bond,2500,0.2,-0.06,7,0.025,1,0.9,0.8,1.0\n");
+        PositionFileWriter rejected(positionPath);
+        bool thrown = false;
+        try {
+            convertCsvPositions(badCsv, rejected);
+        } catch (const InvestmentException&) {
+            thrown = true;
+        }
+        rejected.close();
+        assert(thrown && PositionFileReader(positionPath).size() == 0);
+        for (const char* term : {"7.9", "7e0", "99999999999", ""}) {
+            std::stringstream termCsv(std::string("bond,2500,0.2,0.06,") + term + ",0.025,1,0.9,0.8,1.0\n");
+            PositionFileWriter termRejected(positionPath);
+            try {
+                convertCsvPositions(termCsv, termRejected);
+                assert(false);
+            } catch (const InvestmentException& e) {
+                assert(std::string(e.what()).find("Invalid integer") != std::string::npos);
+            }
+        }
+        std::remove(positionPath);
+        testFile << "PositionFile CSV converter validates rows PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Position File Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Period Simulation Tests
+    try {
+        Bank bank("Stepper", 100000.0);
+        PeriodSimulation simulation(bank, 12);
+        StockInvestment stock(0.4, 0.07, 0.15, 0.02);
+        BondInvestment bond(0.06, 3, 0.02, true);
+        std::size_t stockId = simulation.addHolding(stock, 20000.0);
+        std::size_t bondId = simulation.addBond(bond, 30000.0);
+        assert(bank.getAvailableFunds() == 50000.0);
+        assert(simulation.snapshot().totalValue == 100000.0);
+
+        simulation.advance(11);
+        assert(simulation.positionValue(stockId) == 20000.0 && simulation.eventsProcessed() == 0);
+        simulation.step();
+        assert(std::abs(simulation.positionValue(stockId) - stock.invest(20000.0)) < 1e-9);
+        assert(simulation.eventsProcessed() == 2);
+        testFile << "PeriodSimulation updates positions only on anniversaries PASSED\n";
+
+        std::vector<ValuationSnapshot> snapshots;
+        simulation.advance(24, &snapshots, 6);
+        assert(snapshots.size() == 4 && snapshots.back().period == 36);
+        assert(!simulation.isOpen(bondId) && simulation.openPositions() == 1);
+        assert(bank.getAvailableFunds() == 50000.0 + bond.invest(30000.0));
+        ValuationSnapshot last = snapshots.back();
+        assert(std::abs(last.positionsValue - simulation.positionValue(stockId)) < 1e-6);
+        assert(last.totalValue == last.cash + last.positionsValue);
+        testFile << "PeriodSimulation pays bonds into the bank at maturity PASSED\n";
+
+        double stockValue = simulation.positionValue(stockId);
+        simulation.closePosition(stockId);
+        assert(simulation.openPositions() == 0 && simulation.snapshot().positionsValue == 0.0);
+        assert(std::abs(bank.getAvailableFunds() - (50000.0 + bond.invest(30000.0) + stockValue)) < 1e-6);
+        std::size_t before = simulation.eventsProcessed();
+        simulation.advance(24);
+        assert(simulation.eventsProcessed() == before);
+        testFile << "PeriodSimulation closePosition credits the bank PASSED\n";
+
+        bool threw = false;
+        try {
+            simulation.addHolding(stock, 1e9);
+        } catch (const InvestmentException&) {
+            threw = true;
+        }
+        assert(threw && simulation.size() == 2);
+        testFile << "PeriodSimulation rejects positions the bank cannot fund PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Period Simulation Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Rebalancing Bank Tests
+    try {
+        auto stock = std::make_shared<StockInvestment>(0.5, 0.1, 0.2, 0.02);
+        auto bond = std::make_shared<BondInvestment>(0.05, 4, 0.02);
+        ThreadPool pool(4);
+        RebalancingBank bank("Weighted", 100000.0, pool, 1);
+        std::size_t stockLeg = bank.addLeg(stock, 3.0);
+        std::size_t bondLeg = bank.addLeg(bond, 1.0);
+        assert(bank.getTargetFraction(stockLeg) == 0.75);
+
+        std::vector<double> legValues;
+        double result = bank.executeInvestment(8000.0, &legValues);
+        assert(legValues.size() == 2);
+        assert(legValues[stockLeg] == stock->invest(6000.0) && legValues[bondLeg] == bond->invest(2000.0));
+        assert(result == legValues[0] + legValues[1]);
+        assert(bank.getAvailableFunds() == 92000.0);
+        testFile << "RebalancingBank splits investments by weight PASSED\n";
+
+        bank.setWeights(std::vector<std::pair<std::size_t, double> >(1, std::make_pair(bondLeg, 3.0)));
+        assert(bank.getTargetFraction(bondLeg) == 0.5);
+        double total = bank.getTotalHoldings();
+        std::vector<double> trades = bank.rebalance();
+        assert(std::abs(trades[0] + trades[1]) < 1e-9);
+        assert(std::abs(bank.getHolding(stockLeg) - total / 2) < 1e-9);
+        assert(std::abs(bank.getHolding(bondLeg) - total / 2) < 1e-9);
+        testFile << "RebalancingBank rebalance moves holdings to target weights PASSED\n";
+
+        // Cash legs return their principal, so the leg values are the amounts each leg received
+        auto cash = std::make_shared<InvestmentStrategy>("Cash", 0.0);
+        RebalancingBank churned("Churned", 1000.0);
+        std::size_t large = churned.addLeg(cash, 1e16);
+        std::size_t small = churned.addLeg(cash, 1.0);
+        churned.addLeg(cash, 0.0);
+        churned.setWeight(large, 0.0);
+        assert(churned.getTargetFraction(small) == 1.0);
+        assert(churned.executeInvestment(100.0, &legValues) == 100.0 && legValues[small] == 100.0);
+        for (int i = 0; i < 1000; ++i)
+            churned.setWeight(i % 3, i % 7 == 0 ? 1e15 : 0.001 * (i % 11));
+        churned.setWeights({{0, 0.0}, {1, 0.25}, {2, 0.75}});
+        double invested = churned.executeInvestment(100.0, &legValues);
+        assert(std::abs(legValues[0] + legValues[1] + legValues[2] - 100.0) < 1e-12 && invested == legValues[1] + legValues[2]);
+        assert(churned.getTargetFraction(2) == 0.75 && churned.getAvailableFunds() == 800.0);
+        testFile << "RebalancingBank leg amounts add up to the withdrawal after weight churn PASSED\n";
+
+        RebalancingBank serial("Serial", 1e9, pool, 1000000);
+        RebalancingBank parallel("Parallel", 1e9, pool, 1);
+        for (int i = 0; i < 500; ++i) {
+            auto leg = std::make_shared<StockInvestment>(0.1 + 0.001 * i, 0.05, 0.1, 0.01);
+            serial.addLeg(leg, 1.0 + i % 7);
+            parallel.addLeg(leg, 1.0 + i % 7);
+        }
+        assert(serial.executeInvestment(1e6) == parallel.executeInvestment(1e6));
+        testFile << "RebalancingBank parallel legs match serial evaluation PASSED\n";
+
+        bank.setWeight(stockLeg, 0.0);
+        bank.setWeight(bondLeg, 0.0);
+        bool threw = false;
+        try {
+            bank.executeInvestment(100.0);
+        } catch (const InvestmentException&) {
+            threw = true;
+        }
+        assert(threw && bank.getAvailableFunds() == 92000.0);
+        testFile << "RebalancingBank rejects investing with zero total weight PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Rebalancing Bank Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Strategy Cache Tests
+    try {
+        StrategyCache cache(64);
+        BondInvestment bond(0.05, 5, 0.02, true);
+        BondInvestment sameBond(0.05, 5, 0.02, true);
+        assert(bond.getParameterFingerprint() == sameBond.getParameterFingerprint());
+
+        double risk = cache.calculateRisk(bond);
+        double potential = cache.calculatePotentialReturn(sameBond, 2500.0);
+        assert(risk == bond.calculateRisk());
+        assert(std::abs(potential - bond.calculatePotentialReturn(2500.0)) < 1e-9);
+        assert(cache.misses() == 1 && cache.hits() == 1);
+        testFile << "StrategyCache shares entries between identical configurations PASSED\n";
+
+        std::uint64_t before = bond.getParameterFingerprint();
+        bond.setInterestRate(0.07);
+        assert(bond.getParameterFingerprint() != before);
+        assert(std::abs(cache.calculatePotentialReturn(bond, 2500.0) - bond.calculatePotentialReturn(2500.0)) < 1e-9);
+        bond.setBaseRiskWeight(0.5);
+        assert(cache.calculateRisk(bond) == bond.calculateRisk());
+        sameBond.setRiskRating(0.6);
+        assert(cache.calculateRisk(sameBond) == sameBond.calculateRisk());
+        StockInvestment stock;
+        double stockRisk = cache.calculateRisk(stock);
+        stock.setVolatilityFactor(0.4);
+        assert(cache.calculateRisk(stock) == stock.calculateRisk() && stockRisk != stock.calculateRisk());
+        CryptoInvestment crypto;
+        cache.calculateRisk(crypto);
+        crypto.setJumpVolatility(0.5);
+        assert(cache.calculateRisk(crypto) == crypto.calculateRisk());
+        assert(cache.misses() == 8 && cache.hits() == 1);
+        testFile << "StrategyCache misses after setters change parameters PASSED\n";
+
+        // Two configurations forced onto the same fingerprint
+        struct CollidingStock : StockInvestment {
+            explicit CollidingStock(double risk) : StockInvestment(risk) { updateFingerprint(); }
+            ParameterFingerprint computeFingerprint() const override {
+                ParameterFingerprint hash = StockInvestment::computeFingerprint();
+                hash.key = 42;
+                return hash;
+            }
+        };
+        CollidingStock low(0.2);
+        CollidingStock high(0.9);
+        assert(low.getParameterFingerprint() == high.getParameterFingerprint());
+        assert(low.getParameterCheck() != high.getParameterCheck());
+        assert(cache.calculateRisk(low) == low.calculateRisk());
+        assert(cache.calculateRisk(high) == high.calculateRisk());
+        assert(cache.calculateRisk(low) == low.calculateRisk());
+        testFile << "StrategyCache does not confuse colliding fingerprints PASSED\n";
+
+        // Same name and parameters as the base stock, different evaluation
+        struct HedgedStock : StockInvestment {
+            double calculateRisk() const override { return 0.05; }
+        };
+        StockInvestment plainStock;
+        HedgedStock hedged;
+        assert(plainStock.getParameterFingerprint() == hedged.getParameterFingerprint());
+        assert(cache.calculateRisk(plainStock) == plainStock.calculateRisk());
+        assert(cache.calculateRisk(hedged) == 0.05);
+        testFile << "StrategyCache keys on the dynamic type PASSED\n";
+
+        for (int i = 0; i < 500; ++i)
+            cache.calculateRisk(StockInvestment(0.5, 0.01 + 0.0001 * i));
+        assert(cache.size() <= cache.capacity() && cache.evictions() > 0);
+        cache.invalidate(stock);
+        cache.clear();
+        assert(cache.size() == 0);
+        testFile << "StrategyCache stays within capacity PASSED\n";
+
+        StrategyCache shared(256);
+        std::vector<BondInvestment> configurations;
+        for (int i = 0; i < 32; ++i)
+            configurations.push_back(BondInvestment(0.02 + 0.001 * i, 1 + i % 10, 0.01));
+        std::atomic<bool> mismatch(false);
+        std::vector<std::thread> threads;
+        // More threads than counter stripes, so some threads share a stripe
+        for (int t = 0; t < 24; ++t) {
+            threads.push_back(std::thread([&, t] {
+                for (int i = 0; i < 1000; ++i) {
+                    const BondInvestment& b = configurations[(i * 7 + t) % configurations.size()];
+                    if (shared.calculateRisk(b) != b.calculateRisk())
+                        mismatch = true;
+                }
+            }));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        assert(!mismatch && shared.hits() + shared.misses() == 24000 && shared.misses() >= 32);
+        testFile << "StrategyCache concurrent lookups PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Strategy Cache Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Metrics Tests
+    try {
+        assert(Metrics::bucketIndex(7) == 7 && Metrics::bucketUpperBound(7) == 7);
+        for (std::uint64_t value = 1; value < 5000000; value = value * 3 + 1) {
+            std::uint64_t upper = Metrics::bucketUpperBound(Metrics::bucketIndex(value));
+            assert(upper >= value && upper - value <= value / 8);
+        }
+        assert(Metrics::bucketIndex(~static_cast<std::uint64_t>(0)) == Metrics::BucketCount - 1);
+        testFile << "Metrics histogram buckets within 12.5% PASSED\n";
+
+        Metrics::reset();
+        for (std::uint64_t value = 1; value <= 1000; ++value)
+            Metrics::record(MetricBankExecuteLatency, value);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.push_back(std::thread([] {
+                for (int i = 0; i < 1000; ++i)
+                    Metrics::count(MetricBankInvestments);
+            }));
+        for (auto& thread : threads)
+            thread.join();
+        MetricsSnapshot snapshot = Metrics::snapshot();
+        const HistogramSnapshot& latency = snapshot.histograms[MetricBankExecuteLatency].second;
+        assert(latency.count == 1000 && latency.max == 1000 && std::abs(latency.mean - 500.5) < 1e-9);
+        assert(latency.p50 >= 500 && latency.p50 <= 500 + 500 / 8);
+        assert(latency.p99 >= 990 && latency.p999 <= 1000);
+        assert(snapshot.counters[MetricBankInvestments].second == 4000);
+        testFile << "Metrics aggregate threads that have exited PASSED\n";
+
+        std::string json = snapshot.toJson();
+        assert(json.find("\"bank_investments\": 4000") != std::string::npos);
+        assert(json.find("\"bank_execute_ns\": {\"count\": 1000") != std::string::npos);
+        std::string text = snapshot.toText();
+        assert(text.find("bank_investments 4000\n") != std::string::npos);
+        assert(text.find("bank_execute_ns count=1000 mean=500.5") != std::string::npos);
+        testFile << "Metrics text and JSON export PASSED\n";
+
+        Metrics::reset();
+        Bank bank("Metered", 1000.0);
+        bank.setStrategy(std::make_shared<StockInvestment>());
+        bank.executeInvestment(400.0);
+        bank.withdrawFunds(5000.0);
+        try {
+            bank.executeInvestment(5000.0);
+            assert(false);
+        } catch (const InvestmentException&) {}
+        snapshot = Metrics::snapshot();
+        std::uint64_t expected = Metrics::enabled() ? 1 : 0;
+        assert(snapshot.counters[MetricBankInvestments].second == 2 * expected);
+        assert(snapshot.counters[MetricWithdrawalsDeclined].second == expected);
+        assert(snapshot.counters[MetricInsufficientFunds].second == expected);
+        assert(snapshot.counters[MetricExceptions].second == expected);
+        assert(snapshot.histograms[MetricStrategyInvestLatency].second.count == expected);
+        testFile << "Metrics hot-path instrumentation PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Metrics Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Status Code Tests
+    try {
+        StockInvestment stock;
+        BondInvestment bond;
+        CryptoInvestment crypto;
+        const InvestmentStrategy* strategies[] = { &stock, &bond, &crypto };
+        for (const InvestmentStrategy* strategy : strategies) {
+            InvestmentResult result = strategy->tryInvest(1000.0);
+            assert(result.ok() && result.value == strategy->invest(1000.0));
+            result = strategy->tryCalculatePotentialReturn(1000.0);
+            assert(result.ok() && result.value == strategy->calculatePotentialReturn(1000.0));
+            assert(strategy->tryInvest(0.0).status == StatusInvalidAmount);
+            assert(strategy->tryCalculatePotentialReturn(-5.0).status == StatusInvalidAmount);
+        }
+        testFile << "Strategy try functions match the throwing API PASSED\n";
+
+        Bank bank("Status", 1000.0);
+        assert(bank.tryExecuteInvestment(100.0).status == StatusNoStrategy);
+        bank.setStrategy(std::make_shared<BondInvestment>());
+        assert(bank.tryExecuteInvestment(5000.0).status == StatusInsufficientFunds);
+        assert(bank.tryExecuteInvestment(-10.0).status == StatusInvalidAmount);
+        assert(bank.tryExecuteInvestment(-5000.0).status == StatusInvalidAmount);
+        assert(bank.tryExecuteInvestment(std::nan("")).status == StatusInvalidAmount);
+        assert(bank.getAvailableFunds() == 1000.0);
+        InvestmentResult invested = bank.tryExecuteInvestment(400.0);
+        assert(invested.ok() && invested.value > 400.0 && bank.getAvailableFunds() == 600.0);
+        assert(bank.tryDepositFunds(0.0) == StatusInvalidDeposit);
+        assert(bank.tryWithdrawFunds(-1.0) == StatusInvalidWithdrawal);
+        assert(bank.tryWithdrawFunds(700.0) == StatusInsufficientFunds);
+        assert(bank.tryDepositFunds(50.0) == StatusOk && bank.tryWithdrawFunds(650.0) == StatusOk);
+        assert(bank.getAvailableFunds() == 0.0);
+        testFile << "Bank try functions leave funds untouched on rejection PASSED\n";
+
+        const InvestmentStatus statuses[] = { StatusInvalidAmount, StatusInvalidDeposit, StatusInvalidWithdrawal,
+                                              StatusNoStrategy, StatusInsufficientFunds };
+        for (InvestmentStatus status : statuses) {
+            try {
+                InvestmentResult::failure(status).valueOrThrow();
+                assert(false);
+            } catch (const InvestmentException& e) {
+                assert(std::string(e.what()) == statusMessage(status));
+            }
+        }
+        try {
+            bank.depositFunds(-1.0);
+            assert(false);
+        } catch (const InvestmentException& e) {
+            assert(std::string(e.what()) == "Deposit amount must be positive");
+        }
+        testFile << "Throwing API reports the status messages PASSED\n";
+
+        // Subclasses written against either form are reached through the other
+        struct LegacyDoubling : public InvestmentStrategy {
+            LegacyDoubling() : InvestmentStrategy("LegacyDoubling", 0.2) {}
+            double invest(double amount) const override { return amount * 2.0; }
+            double calculatePotentialReturn(double amount) const override { return amount; }
+        };
+        struct TryDoubling : public InvestmentStrategy {
+            TryDoubling() : InvestmentStrategy("TryDoubling", 0.2) {}
+            InvestmentResult tryInvest(double amount) const override {
+                if (!(amount > 0))
+                    return InvestmentResult::failure(StatusInvalidAmount);
+                return InvestmentResult::success(amount * 2.0);
+            }
+        };
+        LegacyDoubling legacy;
+        TryDoubling doubling;
+        InvestmentStrategy plain("Plain", 0.2);
+        assert(legacy.tryInvest(10.0).value == 20.0 && legacy.tryCalculatePotentialReturn(10.0).value == 10.0);
+        assert(legacy.tryInvest(0.0).status == StatusInvalidAmount);
+        assert(doubling.invest(10.0) == 20.0 && doubling.calculatePotentialReturn(10.0) == 0.0);
+        assert(plain.invest(10.0) == 10.0 && plain.tryInvest(10.0).value == 10.0);
+        assert(plain.calculatePotentialReturn(10.0) == 0.0);
+        Bank legacyBank("Legacy", 100.0);
+        legacyBank.setStrategy(std::make_shared<LegacyDoubling>());
+        assert(legacyBank.executeInvestment(10.0) == 20.0 && legacyBank.getAvailableFunds() == 90.0);
+        testFile << "invest and tryInvest overrides reach each other PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Status Code Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Strategy Arena Tests
+    try {
+        StrategyArena arena(1024);
+        StockInvestment* stock = arena.create<StockInvestment>(0.4, 0.1, 0.2, 0.02);
+        BondInvestment* bond = arena.create<BondInvestment>(0.04, 7, 0.01, true);
+        CryptoInvestment* crypto = arena.create<CryptoInvestment>("Ether", 0.7, 0.8);
+        assert(stock->invest(1000.0) == StockInvestment(0.4, 0.1, 0.2, 0.02).invest(1000.0));
+        assert(bond->invest(1000.0) == BondInvestment(0.04, 7, 0.01, true).invest(1000.0));
+        assert(crypto->getCryptoName() == "Ether" && arena.objectCount() == 3);
+        assert(reinterpret_cast<std::uintptr_t>(bond) % alignof(BondInvestment) == 0);
+        struct alignas(32) AlignedStock : StockInvestment {};
+        for (int i = 0; i < 4; ++i) {
+            arena.create<char>('x');
+            AlignedStock* aligned = arena.create<AlignedStock>();
+            assert(reinterpret_cast<std::uintptr_t>(aligned) % 32 == 0);
+            assert(aligned->invest(1000.0) == StockInvestment().invest(1000.0));
+        }
+        testFile << "StrategyArena creates working strategies PASSED\n";
+
+        std::shared_ptr<int> token = std::make_shared<int>(0);
+        for (int i = 0; i < 200; ++i)
+            arena.create<std::shared_ptr<int> >(token);
+        assert(token.use_count() == 201);
+        std::size_t reserved = arena.bytesReserved();
+        arena.reset();
+        assert(token.use_count() == 1 && arena.objectCount() == 0);
+        for (int i = 0; i < 200; ++i)
+            arena.create<std::shared_ptr<int> >(token);
+        arena.create<BondInvestment>();
+        assert(arena.bytesReserved() == reserved);
+        arena.reset();
+        assert(token.use_count() == 1);
+        testFile << "StrategyArena reset destroys all objects and reuses blocks PASSED\n";
+
+        BondInvestment* lent = arena.create<BondInvestment>(0.05, 3);
+        Bank bank("Arena", 10000.0);
+        bank.setBorrowedStrategy(lent);
+        assert(bank.getCurrentStrategyName() == "Bond");
+        assert(bank.getDetails().find("Current Strategy: Bond") != std::string::npos);
+        assert(bank.executeInvestment(1000.0) == lent->invest(1000.0));
+        Bank copy(bank);
+        assert(copy.executeInvestment(500.0) == lent->invest(500.0));
+        bank.setStrategy(std::make_shared<StockInvestment>());
+        assert(bank.getCurrentStrategyName() == "Stock");
+        assert(bank.tryExecuteInvestment(-1.0).status == StatusInvalidAmount);
+        assert(bank.getAvailableFunds() == 9000.0);
+        try {
+            bank.setBorrowedStrategy(nullptr);
+            assert(false);
+        } catch (const InvestmentException&) {}
+        testFile << "Bank invests through a borrowed strategy PASSED\n";
+
+        Bank contested("Contested", 1000.0);
+        std::shared_ptr<InvestmentStrategy> owned = std::make_shared<StockInvestment>();
+        std::thread borrower([&]() {
+            for (int i = 0; i < 20000; ++i)
+                contested.setBorrowedStrategy(lent);
+        });
+        for (int i = 0; i < 20000; ++i)
+            contested.setStrategy(owned);
+        borrower.join();
+        assert(contested.getStrategy() && contested.getCurrentStrategyName() != "No strategy set");
+        testFile << "Concurrent strategy setters always leave a strategy set PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Strategy Arena Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Journaled Bank Tests
+    try {
+        const char* journalPath = "test_bank.journal";
+        const char* snapshotPath = "test_bank.snapshot";
+        std::remove(journalPath);
+        std::remove(snapshotPath);
+        double expectedFunds = 0.0;
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Durable", 1000.0);
+            bank.depositFunds(500.0);
+            assert(bank.withdrawFunds(200.0) && !bank.withdrawFunds(1e9));
+            bank.setStrategy(std::make_shared<BondInvestment>(0.04, 3, 0.01, true, 0.8));
+            double invested = bank.executeInvestment(300.0);
+            assert(invested == BondInvestment(0.04, 3, 0.01, true, 0.8).invest(300.0));
+            try {
+                bank.executeInvestment(-1.0);
+                assert(false);
+            } catch (const InvestmentException&) {}
+            assert(bank.lastSequence() == 4 && bank.durableSequence() == 4);
+            expectedFunds = bank.getAvailableFunds();
+        }
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Ignored", 0.0);
+            assert(bank.recoveredRecords() == 4 && bank.lastSequence() == 4);
+            assert(bank.getName() == "Durable" && bank.getAvailableFunds() == expectedFunds);
+            assert(bank.getCurrentStrategyName() == "Bond");
+            assert(bank.executeInvestment(100.0) == BondInvestment(0.04, 3, 0.01, true, 0.8).invest(100.0));
+        }
+        testFile << "JournaledBank recovers by replaying the journal PASSED\n";
+
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Ignored");
+            bank.setStrategy(std::make_shared<CryptoInvestment>("Ether", 0.7, 0.6));
+            bank.checkpoint();
+            bank.depositFunds(1000.0);
+            bank.depositFunds(2000.0);
+            expectedFunds = bank.getAvailableFunds();
+        }
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Ignored");
+            assert(bank.recoveredRecords() == 2 && bank.lastSequence() == 8);
+            assert(bank.getAvailableFunds() == expectedFunds && bank.getCurrentStrategyName() == "Crypto");
+        }
+        testFile << "JournaledBank recovers from a snapshot plus the journal tail PASSED\n";
+
+        {
+            struct CustomStock : StockInvestment {
+                double calculateRisk() const override { return 0.05; }
+            };
+            JournaledBank bank(journalPath, snapshotPath, "Ignored");
+            const std::uint64_t sequence = bank.lastSequence();
+            try {
+                bank.setStrategy(std::make_shared<CustomStock>());
+                assert(false);
+            } catch (const InvestmentException&) {}
+            assert(bank.lastSequence() == sequence && bank.getCurrentStrategyName() == "Crypto");
+        }
+        testFile << "JournaledBank refuses strategy types it cannot record PASSED\n";
+
+        // A torn final record is dropped, and appends continue after the last good one
+        {
+            std::FILE* journal = std::fopen(journalPath, "ab");
+            const char partial[7] = {1, 2, 3, 4, 5, 6, 7};
+            std::fwrite(partial, 1, sizeof(partial), journal);
+            std::fclose(journal);
+            JournaledBank bank(journalPath, snapshotPath, "Ignored");
+            assert(bank.recoveredRecords() == 2 && bank.getAvailableFunds() == expectedFunds);
+            bank.depositFunds(1.0);
+        }
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Ignored");
+            assert(bank.recoveredRecords() == 3 && bank.getAvailableFunds() == expectedFunds + 1.0);
+        }
+        testFile << "JournaledBank discards a torn tail PASSED\n";
+
+        std::remove(journalPath);
+        std::remove(snapshotPath);
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Group", 0.0);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < 4; ++t) {
+                threads.push_back(std::thread([&bank] {
+                    for (int i = 0; i < 50; ++i)
+                        bank.depositFunds(1.0);
+                }));
+            }
+            for (auto& thread : threads)
+                thread.join();
+            assert(bank.durableSequence() == 200 && bank.commits() <= 200);
+        }
+        {
+            JournaledBank batched(journalPath, snapshotPath, "Ignored", 0.0, JournalOptions(false, 16));
+            assert(batched.getAvailableFunds() == 200.0);
+            for (int i = 0; i < 40; ++i)
+                batched.depositFunds(1.0);
+            assert(batched.commits() == 2 && batched.durableSequence() == 232);
+            batched.sync();
+            assert(batched.durableSequence() == 240);
+        }
+        testFile << "JournaledBank group and batched commits PASSED\n";
+
+#ifndef _WIN32
+        // A file size limit makes the commit fail part way through its batch
+        std::remove(journalPath);
+        std::remove(snapshotPath);
+        {
+            JournaledBank bank(journalPath, snapshotPath, "Failing", 0.0, JournalOptions(false, 1000));
+            bank.depositFunds(5.0);
+            bank.sync();
+            std::ifstream before(journalPath, std::ios::binary | std::ios::ate);
+            const std::streamoff durableSize = before.tellg();
+            for (int i = 0; i < 10; ++i)
+                bank.depositFunds(1.0);
+            std::signal(SIGXFSZ, SIG_IGN);
+            struct rlimit saved;
+            getrlimit(RLIMIT_FSIZE, &saved);
+            struct rlimit limited = saved;
+            limited.rlim_cur = static_cast<rlim_t>(durableSize) + 30;
+            setrlimit(RLIMIT_FSIZE, &limited);
+            bool thrown = false;
+            try {
+                bank.sync();
+            } catch (const InvestmentException&) {
+                thrown = true;
+            }
+            setrlimit(RLIMIT_FSIZE, &saved);
+            std::signal(SIGXFSZ, SIG_DFL);
+            assert(thrown);
+            std::ifstream after(journalPath, std::ios::binary | std::ios::ate);
+            assert(after.tellg() == durableSize);
+            try {
+                bank.depositFunds(1.0);
+                assert(false);
+            } catch (const InvestmentException&) {}
+            try {
+                bank.sync();
+                assert(false);
+            } catch (const InvestmentException&) {}
+        }
+        {
+            JournaledBank reopened(journalPath, snapshotPath, "Ignored", 0.0);
+            assert(reopened.getAvailableFunds() == 5.0 && reopened.lastSequence() == 1);
+            reopened.depositFunds(2.0);
+        }
+        {
+            JournaledBank reopened(journalPath, snapshotPath, "Ignored", 0.0);
+            assert(reopened.getAvailableFunds() == 7.0 && reopened.recoveredRecords() == 2);
+        }
+        testFile << "JournaledBank stops after a failed commit without leaving a gap PASSED\n";
+#endif
+        std::remove(journalPath);
+        std::remove(snapshotPath);
+    } catch (const std::exception &e) {
+        testFile << "Journaled Bank Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Investment Pipeline Tests
+    try {
+        std::shared_ptr<InvestmentStrategy> stock = std::make_shared<StockInvestment>(0.4, 0.1, 0.2, 0.02);
+        std::shared_ptr<InvestmentStrategy> bond = std::make_shared<BondInvestment>(0.04, 7);
+        std::vector<std::unique_ptr<Bank> > banks;
+        for (int i = 0; i < 20; ++i) {
+            banks.push_back(std::unique_ptr<Bank>(new Bank("Pipeline", 10000.0)));
+            banks.back()->setStrategy(i % 2 == 0 ? stock : bond);
+        }
+        {
+            InvestmentPipeline pipeline;
+            std::vector<std::future<InvestmentResult> > results;
+            for (int i = 0; i < 100; ++i)
+                results.push_back(pipeline.submit(*banks[i % 20], 100.0 + i));
+            for (int i = 0; i < 100; ++i) {
+                InvestmentResult result = results[i].get();
+                assert(result.ok() && result.value == (i % 2 == 0 ? stock : bond)->invest(100.0 + i));
+            }
+            double expectedFunds = 10000.0;
+            for (int i = 0; i < 100; i += 20)
+                expectedFunds -= 100.0 + i;
+            assert(banks[0]->getAvailableFunds() == expectedFunds);
+            assert(pipeline.submitted() == 100);
+        }
+        testFile << "Pipeline results match executeInvestment PASSED\n";
+
+        {
+            struct FailingStrategy : InvestmentStrategy {
+                FailingStrategy() : InvestmentStrategy("Failing", 0.5) {}
+                void investBatch(const double*, double*, std::size_t) const override {
+                    throw InvestmentException("valuation failed");
+                }
+            };
+            Bank empty("Empty", 100.0);
+            Bank failing("Failing", 100.0);
+            failing.setStrategy(std::make_shared<FailingStrategy>());
+            InvestmentPipeline pipeline;
+            std::future<InvestmentResult> noStrategy = pipeline.submit(empty, 10.0);
+            std::future<InvestmentResult> invalid = pipeline.submit(*banks[0], -5.0);
+            std::future<InvestmentResult> insufficient = pipeline.submit(*banks[1], 1e9);
+            std::future<InvestmentResult> failed = pipeline.submit(failing, 40.0);
+            std::future<InvestmentResult> notANumber = pipeline.submit(*banks[0], std::nan(""));
+            assert(noStrategy.get().status == StatusNoStrategy);
+            assert(invalid.get().status == StatusInvalidAmount);
+            assert(notANumber.get().status == StatusInvalidAmount);
+            assert(insufficient.get().status == StatusInsufficientFunds);
+            assert(failed.get().status == StatusStrategyFailed);
+            assert(failing.getAvailableFunds() == 100.0 && empty.getAvailableFunds() == 100.0);
+        }
+        testFile << "Pipeline reports rejections as statuses PASSED\n";
+
+        {
+            struct DoublingStrategy : InvestmentStrategy {
+                DoublingStrategy() : InvestmentStrategy("Doubling", 0.2) {}
+                double invest(double amount) const override { return amount * 2.0; }
+            };
+            Bank doubling("Doubling", 100.0, std::make_shared<DoublingStrategy>());
+            InvestmentPipeline pipeline;
+            InvestmentResult result = pipeline.submit(doubling, 10.0).get();
+            assert(result.ok() && result.value == doubling.tryExecuteInvestment(10.0).value);
+            assert(result.value == 20.0 && doubling.getAvailableFunds() == 80.0);
+        }
+        testFile << "Pipeline values through overridden invest PASSED\n";
+
+        {
+            Bank shared("Shared", 1e9);
+            shared.setStrategy(stock);
+            std::atomic<int> callbacks(0);
+            std::atomic<int> failures(0);
+            InvestmentPipeline pipeline(PipelineOptions(4, 3, std::chrono::microseconds(50)));
+            std::vector<std::thread> producers;
+            for (int t = 0; t < 4; ++t) {
+                producers.push_back(std::thread([&] {
+                    for (int i = 0; i < 250; ++i) {
+                        pipeline.submit(shared, 10.0, [&](const InvestmentResult& result) {
+                            if (!result.ok() || result.value != stock->invest(10.0))
+                                failures.fetch_add(1);
+                            callbacks.fetch_add(1);
+                        });
+                    }
+                }));
+            }
+            for (auto& producer : producers)
+                producer.join();
+            pipeline.flush();
+            assert(callbacks.load() == 1000 && failures.load() == 0);
+            assert(pipeline.completed() == 1000 && pipeline.batches() >= 1000 / 3);
+            assert(shared.getAvailableFunds() == 1e9 - 10000.0);
+        }
+        testFile << "Pipeline callbacks with backpressure from several producers PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Investment Pipeline Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Risk Aggregator Tests
+    try {
+        RiskBook book(3);
+        book.setCorrelation(0, 0, 0.6);
+        book.setCorrelation(0, 1, 0.3);
+        book.setCorrelation(1, 2, -0.2);
+        std::vector<std::shared_ptr<InvestmentStrategy> > strategies;
+        for (int i = 0; i < 40; ++i) {
+            if (i % 3 == 2)
+                strategies.push_back(std::make_shared<BondInvestment>(0.03 + 0.001 * i, 1 + i % 9, 0.02, i % 2 == 0));
+            else
+                strategies.push_back(std::make_shared<StockInvestment>(0.2 + 0.01 * i, 0.1, 0.05 + 0.005 * i, 0.02));
+            book.add(*strategies.back(), 100.0 + 37.0 * i, static_cast<std::size_t>(i % 3));
+        }
+        ThreadPool single(1);
+        RiskSummary summary = RiskAggregator(single, 8).aggregate(book);
+
+        double exposure = 0.0;
+        double weighted = 0.0;
+        double variance = 0.0;
+        for (std::size_t i = 0; i < book.size(); ++i) {
+            const double wi = book.exposures()[i] * strategies[i]->calculateRisk();
+            exposure += book.exposures()[i];
+            weighted += wi;
+            for (std::size_t j = 0; j < book.size(); ++j) {
+                const double wj = book.exposures()[j] * strategies[j]->calculateRisk();
+                variance += i == j ? wi * wj : book.correlation(book.buckets()[i], book.buckets()[j]) * wi * wj;
+            }
+        }
+        assert(summary.positions == 40 && std::abs(summary.exposure - exposure) < 1e-9);
+        assert(std::abs(summary.weightedRisk - weighted / exposure) < 1e-12);
+        assert(std::abs(summary.volatility - std::sqrt(variance) / exposure) < 1e-12);
+        double shares = 0.0;
+        for (const RiskBucketSummary& bucket : summary.buckets)
+            shares += bucket.varianceShare;
+        assert(std::abs(shares - 1.0) < 1e-12 && summary.buckets[1].positions == 13);
+        testFile << "RiskAggregator matches the pairwise covariance sum PASSED\n";
+
+        RiskBook large(16);
+        for (int i = 0; i < 100000; ++i)
+            large.addRisk(0.05 + (i % 97) * 0.003, 10.0 + (i * 7919) % 1000, static_cast<std::size_t>(i % 16));
+        ThreadPool many(4);
+        RiskSummary sequential = RiskAggregator(single, 1024).aggregate(large);
+        RiskSummary parallel = RiskAggregator(many, 1024).aggregate(large);
+        assert(sequential.volatility == parallel.volatility && sequential.weightedRisk == parallel.weightedRisk);
+        for (std::size_t b = 0; b < 16; ++b)
+            assert(sequential.buckets[b].volatility == parallel.buckets[b].volatility);
+        assert(sequential.volatility < sequential.weightedRisk);
+        testFile << "RiskAggregator is bit-identical across thread counts PASSED\n";
+
+        Portfolio portfolio;
+        StockInvestment stock(0.4, 0.1, 0.2, 0.02);
+        BondInvestment bond(0.04, 7, 0.01, true);
+        portfolio.addStock(stock, 500.0);
+        portfolio.addBond(bond, 1500.0);
+        RiskBook fromPortfolio(2);
+        fromPortfolio.addPortfolio(portfolio, 0, 1);
+        RiskSummary split = RiskAggregator(single).aggregate(fromPortfolio);
+        assert(split.buckets[0].weightedRisk == stock.calculateRisk() && split.buckets[1].weightedRisk == bond.calculateRisk());
+        assert(std::abs(split.volatility * 2000.0 - std::sqrt(std::pow(500.0 * stock.calculateRisk(), 2) +
+                                                            std::pow(1500.0 * bond.calculateRisk(), 2))) < 1e-9);
+        try {
+            fromPortfolio.setCorrelation(0, 1, 1.5);
+            assert(false);
+        } catch (const InvestmentException&) {}
+        try {
+            fromPortfolio.addRisk(0.1, 10.0, 2);
+            assert(false);
+        } catch (const InvestmentException&) {}
+        testFile << "RiskBook loads portfolios and validates input PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Risk Aggregator Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Bank Cluster Tests
+    try {
+        std::shared_ptr<InvestmentStrategy> stock = std::make_shared<StockInvestment>(0.4, 0.1, 0.2, 0.02);
+        std::shared_ptr<InvestmentStrategy> bond = std::make_shared<BondInvestment>(0.04, 7);
+        {
+            BankCluster cluster(3);
+            std::vector<BankId> ids;
+            for (int i = 0; i < 30; ++i)
+                ids.push_back(cluster.addBank(i % 2 == 0 ? "Even" : "Odd", 1000.0));
+            assert(cluster.shardCount() == 3 && cluster.bankCount() == 30);
+            std::size_t matched = cluster.setStrategyWhere(stock, [](const Bank& bank) { return bank.getName() == "Even"; });
+            assert(matched == 15);
+            assert(cluster.setStrategyWhere(bond, [](const Bank& bank) { return !bank.getStrategy(); }) == 15);
+            cluster.invest(ids[0], 100.0);
+            cluster.invest(ids[1], 100.0);
+            cluster.invest(ids[2], 5000.0);
+            cluster.deposit(ids[3], -1.0);
+            cluster.quiesce();
+            assert(cluster.availableFunds(ids[0]) == 900.0 && cluster.availableFunds(ids[2]) == 1000.0);
+            assert(cluster.investWhere(10.0, [](const Bank& bank) { return bank.getName() == "Odd"; }) == 15);
+            ClusterStats stats = cluster.stats();
+            assert(stats.investments == 17 && stats.rejected == 2);
+            assert(std::abs(stats.investedValue - (stock->invest(100.0) + bond->invest(100.0) + 15 * bond->invest(10.0))) < 1e-9);
+        }
+        testFile << "BankCluster routes operations and bulk updates by predicate PASSED\n";
+
+        {
+            struct ThrowingStrategy : InvestmentStrategy {
+                ThrowingStrategy() : InvestmentStrategy("Throwing", 0.5) {}
+                double invest(double) const override { throw InvestmentException("valuation failed"); }
+            };
+            BankCluster cluster(2);
+            const BankId id = cluster.addBank("Throwing", 100.0);
+            assert(cluster.setStrategyWhere(std::make_shared<ThrowingStrategy>(), [](const Bank&) { return true; }) == 1);
+            cluster.invest(id, 10.0);
+            assert(cluster.investWhere(10.0, [](const Bank&) { return true; }) == 1);
+            cluster.quiesce();
+            ClusterStats stats = cluster.stats();
+            assert(stats.rejected == 2 && stats.investments == 0);
+            assert(cluster.availableFunds(id) == 100.0);
+        }
+        testFile << "BankCluster counts throwing strategies as rejected PASSED\n";
+
+        {
+            BankCluster cluster(4);
+            const int banks = 64;
+            for (int i = 0; i < banks; ++i)
+                cluster.addBank("Client", 100.0);
+            std::vector<std::thread> producers;
+            for (int t = 0; t < 4; ++t) {
+                producers.push_back(std::thread([&cluster, t] {
+                    for (int i = 0; i < 2000; ++i)
+                        cluster.transfer(static_cast<BankId>((i * 7 + t) % banks), static_cast<BankId>((i * 13 + t * 5) % banks), 3.0);
+                }));
+            }
+            for (auto& producer : producers)
+                producer.join();
+            cluster.quiesce();
+            ClusterStats stats = cluster.stats();
+            assert(stats.transfers + stats.transfersDeclined == 8000 && stats.transfers > 0);
+            assert(cluster.totalFunds() == banks * 100.0);
+            double sum = 0.0;
+            for (int i = 0; i < banks; ++i)
+                sum += cluster.availableFunds(static_cast<BankId>(i));
+            assert(sum == banks * 100.0);
+            try {
+                cluster.transfer(0, banks, 1.0);
+                assert(false);
+            } catch (const InvestmentException&) {}
+        }
+        testFile << "BankCluster transfers across shards conserve funds PASSED\n";
+
+        {
+            BankCluster cluster(2);
+            std::thread adder([&cluster] {
+                for (int i = 0; i < 2000; ++i)
+                    cluster.addBank("New", 0.0);
+            });
+            int deposits = 0;
+            while (cluster.bankCount() < 2000) {
+                const std::size_t count = cluster.bankCount();
+                if (count > 0) {
+                    cluster.deposit(static_cast<BankId>(count - 1), 1.0);
+                    ++deposits;
+                }
+            }
+            adder.join();
+            cluster.quiesce();
+            assert(cluster.totalFunds() == deposits && cluster.stats().rejected == 0);
+        }
+        testFile << "BankCluster ids are usable as soon as they are counted PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Bank Cluster Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Sensitivity Tests
+    try {
+        // Central differences on the double instantiation of the shared formulas
+        auto close = [](double ad, double fd) { return std::abs(ad - fd) <= 1e-5 * (1.0 + std::abs(fd)); };
+        const double h = 1e-6;
+
+        StockInvestment stock(0.4, 0.11, 0.25, 0.03);
+        StockSensitivities s = investSensitivities(stock, 1000.0);
+        assert(s.value == stock.invest(1000.0));
+        double p[5] = {1000.0, 0.4, 0.11, 0.25, 0.03};
+        const double stockAd[5] = {s.amount, s.riskRating, s.expectedReturn, s.volatilityFactor, s.dividendYield};
+        for (int i = 0; i < 5; ++i) {
+            const double saved = p[i];
+            const double step = h * (1.0 + std::abs(saved));
+            p[i] = saved + step;
+            const double up = stockInvestValue(p[0], stockRisk(p[1], p[3]), p[2], p[3], p[4]);
+            p[i] = saved - step;
+            const double down = stockInvestValue(p[0], stockRisk(p[1], p[3]), p[2], p[3], p[4]);
+            p[i] = saved;
+            assert(close(stockAd[i], (up - down) / (2.0 * step)));
+        }
+        testFile << "Stock sensitivities match finite differences PASSED\n";
+
+        // Callable and plain bonds, on both sides of the inflation branch
+        const BondInvestment bonds[] = { BondInvestment(0.05, 10, 0.02, true, 0.9, 0.8, 1.2),
+                                         BondInvestment(0.05, 7, 0.02, false, 0.9, 0.8, 1.2),
+                                         BondInvestment(0.015, 5, 0.03, false) };
+        for (const BondInvestment& bond : bonds) {
+            BondSensitivities b = investSensitivities(bond, 2500.0);
+            assert(b.value == bond.invest(2500.0));
+            double q[6] = {2500.0, bond.getInterestRate(), static_cast<double>(bond.getTermYears()), bond.getInflationRate(),
+                           bond.getCallableAdjustment(), bond.getInflationAdjustment()};
+            const double bondAd[6] = {b.amount, b.interestRate, b.termYears, b.inflationRate, b.callableAdjustment,
+                                      b.inflationAdjustment};
+            for (int i = 0; i < 6; ++i) {
+                const double saved = q[i];
+                const double step = h * (1.0 + std::abs(saved));
+                double values[2];
+                for (int side = 0; side < 2; ++side) {
+                    q[i] = saved + (side == 0 ? step : -step);
+                    const double rate = bondEffectiveRate(q[1], q[3], bond.isCallable(), q[4], q[5]);
+                    values[side] = q[0] * bondGrowthFactor(rate, q[2]);
+                }
+                q[i] = saved;
+                assert(close(bondAd[i], (values[0] - values[1]) / (2.0 * step)));
+            }
+            if (!bond.isCallable())
+                assert(b.callableAdjustment == 0.0);
+        }
+        assert(investSensitivities(bonds[2], 100.0).inflationAdjustment == 0.0);
+        try {
+            investSensitivities(stock, 0.0);
+            assert(false);
+        } catch (const InvestmentException&) {}
+        testFile << "Bond sensitivities match finite differences through pow and branches PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Sensitivity Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Bank Snapshot Tests
+    try {
+        const char* snapshotPath = "test_banks.snapshot";
+        std::shared_ptr<InvestmentStrategy> sharedBond = std::make_shared<BondInvestment>(0.045, 8, 0.015, true, 0.85, 0.7, 1.3);
+        std::shared_ptr<CryptoInvestment> crypto = std::make_shared<CryptoInvestment>("Ether", 0.7, 0.9);
+        crypto->setRiskRating(0.9);
+        BondInvestment lent(0.03, 4);
+        std::vector<Bank> banks;
+        banks.push_back(Bank("First", 1000.0, std::make_shared<StockInvestment>(0.35, 0.1, 0.25, 0.02)));
+        banks.push_back(Bank("Second", 250.5, sharedBond));
+        banks.push_back(Bank("Third", 0.0, sharedBond));
+        banks.push_back(Bank("", 42.0, crypto));
+        banks.push_back(Bank("No strategy", 7.0));
+        banks.push_back(Bank("Base", 1.0, std::make_shared<InvestmentStrategy>("Custom", 0.3)));
+        banks.push_back(Bank("Borrowed", 5.0));
+        banks.back().setBorrowedStrategy(&lent);
+        saveBankSnapshot(snapshotPath, banks);
+
+        std::vector<Bank> loaded = loadBankSnapshot(snapshotPath);
+        assert(loaded.size() == banks.size());
+        for (std::size_t i = 0; i < banks.size(); ++i) {
+            assert(loaded[i].getName() == banks[i].getName());
+            assert(loaded[i].getAvailableFunds() == banks[i].getAvailableFunds());
+            assert(loaded[i].getCurrentStrategyName() == banks[i].getCurrentStrategyName());
+            assert(loaded[i].getDetails() == banks[i].getDetails());
+            std::shared_ptr<const InvestmentStrategy> before = banks[i].getStrategy();
+            std::shared_ptr<const InvestmentStrategy> after = loaded[i].getStrategy();
+            assert(!before == !after);
+            if (before) {
+                assert(after->getParameterFingerprint() == before->getParameterFingerprint());
+                assert(after->getInvestmentDetails(1000.0) == before->getInvestmentDetails(1000.0));
+            }
+        }
+        assert(loaded[1].getStrategy() == loaded[2].getStrategy());
+        const BondInvestment* bond = dynamic_cast<const BondInvestment*>(loaded[1].getStrategy().get());
+        assert(bond && bond->getCallableAdjustment() == 0.85 && bond->getBaseRiskWeight() == 0.7 &&
+               bond->getInflationAdjustment() == 1.3);
+        assert(loaded[1].executeInvestment(100.0) == sharedBond->invest(100.0));
+        testFile << "Bank snapshot round-trips names, funds and shared strategies PASSED\n";
+
+        struct CustomBond : BondInvestment {
+            double calculateRisk() const override { return 0.01; }
+        };
+        std::vector<Bank> custom(banks);
+        custom.push_back(Bank("Custom", 3.0, std::make_shared<CustomBond>()));
+        try {
+            saveBankSnapshot(snapshotPath, custom);
+            assert(false);
+        } catch (const InvestmentException&) {}
+        assert(loadBankSnapshot(snapshotPath).size() == banks.size());
+        testFile << "Bank snapshot refuses strategy types it cannot record PASSED\n";
+
+        const std::string temporaryPath = std::string(snapshotPath) + ".tmp";
+        assert(!std::fopen(temporaryPath.c_str(), "rb"));
+        saveBankSnapshot(snapshotPath, std::vector<Bank>(banks.begin(), banks.begin() + 2));
+        assert(loadBankSnapshot(snapshotPath).size() == 2 && !std::fopen(temporaryPath.c_str(), "rb"));
+        saveBankSnapshot(snapshotPath, banks);
+        testFile << "Bank snapshot replaces the previous file through a temporary PASSED\n";
+
+        {
+            std::FILE* file = std::fopen(snapshotPath, "r+b");
+            std::fseek(file, 0, SEEK_END);
+            long size = std::ftell(file);
+            std::fclose(file);
+            std::vector<char> contents(static_cast<std::size_t>(size));
+            file = std::fopen(snapshotPath, "rb");
+            assert(std::fread(contents.data(), 1, contents.size(), file) == contents.size());
+            std::fclose(file);
+            file = std::fopen(snapshotPath, "wb");
+            std::fwrite(contents.data(), 1, contents.size() - 1, file);
+            std::fclose(file);
+        }
+        try {
+            loadBankSnapshot(snapshotPath);
+            assert(false);
+        } catch (const InvestmentException& e) {
+            assert(std::string(e.what()).find("corrupt") != std::string::npos);
+        }
+        std::remove(snapshotPath);
+        testFile << "Bank snapshot rejects truncated files PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Bank Snapshot Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Bank Batch Tests
+    try {
+        std::shared_ptr<InvestmentStrategy> stock = std::make_shared<StockInvestment>(0.35, 0.1, 0.25, 0.02);
+        BondInvestment bond(0.045, 8, 0.015, true);
+        std::vector<Bank> batched;
+        batched.push_back(Bank("Stock", 1000.0, stock));
+        batched.push_back(Bank("Bond", 500.0));
+        batched.back().setBorrowedStrategy(&bond);
+        batched.push_back(Bank("Idle", 50.0));
+        std::vector<Bank> sequential(batched);
+
+        const BankOperation operations[] = {
+            {0, OperationInvestment, 400.0}, {0, OperationInvestment, 700.0}, {0, OperationDeposit, 300.0},
+            {0, OperationInvestment, 700.0}, {1, OperationWithdrawal, 200.0}, {1, OperationWithdrawal, 400.0},
+            {1, OperationInvestment, 150.0}, {1, OperationInvestment, -1.0}, {1, OperationInvestment, 0.0},
+            {2, OperationInvestment, 10.0},  {2, OperationDeposit, -5.0},     {2, OperationWithdrawal, 0.0},
+            {2, OperationWithdrawal, 50.0},  {0, OperationInvestment, 1.0},   {1, OperationDeposit, 25.0},
+            {2, OperationWithdrawal, 1e9},   {0, OperationInvestment, std::nan("")}};
+        const std::size_t count = sizeof(operations) / sizeof(operations[0]);
+        InvestmentStatus statuses[count];
+        double values[count];
+        std::size_t succeeded = Bank::applyOperations(batched.data(), batched.size(), operations, count, statuses, values);
+
+        std::size_t expectedSucceeded = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            Bank& bank = sequential[operations[i].bank];
+            InvestmentStatus expected;
+            double value = 0.0;
+            if (operations[i].type == OperationDeposit) {
+                expected = bank.tryDepositFunds(operations[i].amount);
+            } else if (operations[i].type == OperationWithdrawal) {
+                expected = bank.tryWithdrawFunds(operations[i].amount);
+            } else {
+                InvestmentResult result = bank.tryExecuteInvestment(operations[i].amount);
+                expected = result.status;
+                value = result.value;
+            }
+            assert(statuses[i] == expected);
+            if (operations[i].type == OperationInvestment && expected == StatusOk)
+                assert(values[i] == value);
+            else
+                assert(values[i] == bank.getAvailableFunds());
+            expectedSucceeded += expected == StatusOk;
+        }
+        assert(succeeded == expectedSucceeded);
+        for (std::size_t i = 0; i < batched.size(); ++i)
+            assert(batched[i].getAvailableFunds() == sequential[i].getAvailableFunds());
+        assert(statuses[1] == StatusInsufficientFunds && statuses[7] == StatusInvalidAmount &&
+               statuses[9] == StatusNoStrategy && statuses[10] == StatusInvalidDeposit &&
+               statuses[11] == StatusInvalidWithdrawal && statuses[12] == StatusOk);
+        testFile << "Batch operations match sequential try calls PASSED\n";
+
+        const BankOperation outOfRange[] = {{0, OperationDeposit, 10.0}, {3, OperationDeposit, 10.0}};
+        try {
+            Bank::applyOperations(batched.data(), batched.size(), outOfRange, 2, statuses, values);
+            assert(false);
+        } catch (const InvestmentException&) {
+        }
+        assert(batched[0].getAvailableFunds() == sequential[0].getAvailableFunds());
+
+        struct FailingStrategy : InvestmentStrategy {
+            FailingStrategy() : InvestmentStrategy("Failing", 0.5) {}
+            void investBatch(const double*, double*, std::size_t) const override {
+                throw InvestmentException("valuation failed");
+            }
+        };
+        batched[2].setStrategy(std::make_shared<FailingStrategy>());
+        const BankOperation failing[] = {{2, OperationDeposit, 100.0}, {2, OperationInvestment, 80.0},
+                                         {0, OperationDeposit, 1.0}};
+        succeeded = Bank::applyOperations(batched.data(), batched.size(), failing, 3, statuses, values);
+        assert(succeeded == 2 && statuses[1] == StatusStrategyFailed);
+        assert(batched[2].getAvailableFunds() == 100.0);
+
+        // The refund lands before the next block of 1024 operations is checked
+        std::vector<BankOperation> spanning(1025, BankOperation{0, OperationDeposit, 1.0});
+        spanning[0] = BankOperation{2, OperationInvestment, 100.0};
+        spanning[1024] = BankOperation{2, OperationWithdrawal, 100.0};
+        std::vector<InvestmentStatus> spanningStatuses(spanning.size());
+        std::vector<double> spanningValues(spanning.size());
+        Bank::applyOperations(batched.data(), batched.size(), spanning.data(), spanning.size(),
+                              spanningStatuses.data(), spanningValues.data());
+        assert(spanningStatuses[0] == StatusStrategyFailed && spanningStatuses[1024] == StatusOk);
+        assert(batched[2].getAvailableFunds() == 0.0);
+        testFile << "Batch operations reject bad input and refund failed strategies PASSED\n";
+
+        struct DoublingStrategy : InvestmentStrategy {
+            DoublingStrategy() : InvestmentStrategy("Doubling", 0.2) {}
+            double invest(double amount) const override { return amount * 2.0; }
+        };
+        std::vector<Bank> doubling(1, Bank("Doubling", 100.0, std::make_shared<DoublingStrategy>()));
+        const BankOperation doubled[] = {{0, OperationInvestment, 10.0}};
+        assert(Bank::applyOperations(doubling.data(), 1, doubled, 1, statuses, values) == 1);
+        assert(statuses[0] == StatusOk && values[0] == 20.0);
+        assert(doubling[0].tryExecuteInvestment(10.0).value == values[0]);
+        testFile << "Batch operations value through overridden invest PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Bank Batch Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
+    // Yield Curve Tests
+    try {
+        std::shared_ptr<YieldCurve> curve = std::make_shared<YieldCurve>(std::vector<double>{1.0, 5.0, 10.0},
+                                                                         std::vector<double>{0.02, 0.03, 0.04}, 30);
+        assert(curve->zeroRate(0.5) == 0.02 && curve->zeroRate(20.0) == 0.04);
+        assert(std::fabs(curve->zeroRate(3.0) - 0.025) < 1e-15);
+        assert(std::fabs(curve->growthFactor(7) * curve->discountFactor(7) - 1.0) < 1e-15);
+        assert(curve->growthFactor(0) == 1.0);
+
+        BondInvestment bond(0.05, 7, 0.01, true);
+        bond.setYieldCurve(curve);
+        BondInvestment flat(curve->gridZeroRate(7), 7, 0.01, true);
+        assert(bond.getInterestRate() == curve->gridZeroRate(7));
+        assert(bond.invest(1000.0) == flat.invest(1000.0));
+        assert(bond.getParameterFingerprint() == flat.getParameterFingerprint());
+        bond.setTermYears(3);
+        assert(bond.getInterestRate() == curve->gridZeroRate(3));
+        bond.setTermYears(7);
+        testFile << "Curve bonds price like flat bonds at the curve rate PASSED\n";
+
+        std::shared_ptr<YieldCurve> other = std::make_shared<YieldCurve>(std::vector<double>{1.0}, std::vector<double>{0.05});
+        std::vector<BondInvestment> book(3, bond);
+        BondInvestment elsewhere(0.03, 10);
+        elsewhere.setYieldCurve(other);
+        assert(curve->dependentCount() == 4 && other->dependentCount() == 1);
+        const std::uint64_t elsewhereFingerprint = elsewhere.getParameterFingerprint();
+        const std::uint64_t flatFingerprint = flat.getParameterFingerprint();
+        const double before = book[1].invest(1000.0);
+        curve->setZeroRates(std::vector<double>{1.0, 5.0, 10.0}, std::vector<double>{0.03, 0.04, 0.05});
+        BondInvestment shifted(curve->gridZeroRate(7), 7, 0.01, true);
+        for (std::size_t i = 0; i < book.size(); ++i)
+            assert(book[i].invest(1000.0) == shifted.invest(1000.0));
+        assert(bond.invest(1000.0) == shifted.invest(1000.0) && bond.invest(1000.0) > before);
+        assert(bond.getParameterFingerprint() == shifted.getParameterFingerprint());
+        assert(elsewhere.getParameterFingerprint() == elsewhereFingerprint);
+        assert(flat.getParameterFingerprint() == flatFingerprint);
+        book.clear();
+        assert(curve->dependentCount() == 1);
+        testFile << "Curve updates reprice only the attached bonds PASSED\n";
+
+        assert(curve->adjustedGridCount() == 1);
+        BondInvestment churn(0.03, 5);
+        churn.setYieldCurve(curve);
+        assert(curve->adjustedGridCount() == 2);
+        for (int i = 1; i <= 100; ++i)
+            churn.setInflationRate(0.02 + 0.0001 * i);
+        churn.setCallable(true);
+        assert(curve->adjustedGridCount() == 2);
+        churn.setInflationRate(0.01);
+        assert(curve->adjustedGridCount() == 1);
+        assert(churn.invest(1000.0) == BondInvestment(curve->gridZeroRate(5), 5, 0.01, true).invest(1000.0));
+        churn.setInflationRate(0.02);
+        {
+            BondInvestment copy(churn);
+            assert(curve->adjustedGridCount() == 2);
+            churn.setYieldCurve(nullptr);
+            assert(curve->adjustedGridCount() == 2);
+        }
+        assert(curve->adjustedGridCount() == 1 && curve->dependentCount() == 1);
+        testFile << "Curve keeps grids only for adjustments its bonds use PASSED\n";
+
+        try {
+            bond.setInterestRate(0.02);
+            assert(false);
+        } catch (const InvestmentException&) {
+        }
+        try {
+            bond.setTermYears(31);
+            assert(false);
+        } catch (const InvestmentException&) {
+        }
+        bond.setYieldCurve(nullptr);
+        assert(curve->dependentCount() == 0);
+        assert(bond.invest(1000.0) == shifted.invest(1000.0));
+        bond.setInterestRate(0.02);
+
+        // A flat 5% par curve has 5% zero rates
+        std::vector<double> zeros = YieldCurve::bootstrapZeroRates(std::vector<int>{1, 2, 5, 10},
+                                                                   std::vector<double>{0.05, 0.05, 0.05, 0.05});
+        for (std::size_t i = 0; i < zeros.size(); ++i)
+            assert(std::fabs(zeros[i] - 0.05) < 1e-12);
+        // Two-year par yield 4% after a 3% first year: 0.04 * d1 + 1.04 * d2 = 1
+        zeros = YieldCurve::bootstrapZeroRates(std::vector<int>{1, 2}, std::vector<double>{0.03, 0.04});
+        const double d2 = (1.0 - 0.04 / 1.03) / 1.04;
+        assert(std::fabs(zeros[0] - 0.03) < 1e-15 && std::fabs(zeros[1] - (1.0 / std::sqrt(d2) - 1.0)) < 1e-15);
+        testFile << "Curve checks inputs and bootstraps par yields PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Yield Curve Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
     // CryptoInvestment Tests
     try {
         auto crypto = std::make_shared<CryptoInvestment>("Bitcoin", 0.9, 1.0, 1.2);
@@ -133,6 +1803,91 @@ int main() {
         assert(false);
     }
 
+    // Crypto Jump-Diffusion Tests
+    try {
+        CryptoInvestment crypto("Bitcoin", 0.3, 1.0, 3.0, -0.1, 0.3);
+        MonteCarloSettings settings(100000, 1, 1.0, 0.95, 11);
+
+        ThreadPool single(1);
+        ThreadPool several(4);
+        MonteCarloResult a = crypto.simulate(amount, settings, single);
+        MonteCarloResult b = crypto.simulate(amount, settings, several);
+        assert(a.mean == b.mean && a.percentile5 == b.percentile5 && a.valueAtRisk == b.valueAtRisk);
+
+        std::vector<double> whole(1000), split(1000);
+        crypto.sampleTerminalValues(amount, 1.0, 11, 0, whole.data(), whole.size());
+        crypto.sampleTerminalValues(amount, 1.0, 11, 0, split.data(), 300);
+        crypto.sampleTerminalValues(amount, 1.0, 11, 300, split.data() + 300, 700);
+        assert(whole == split);
+        testFile << "CryptoInvestment simulate reproducible across threads and batches PASSED\n";
+
+        double expectedMean = crypto.invest(amount);
+        assert(std::abs(a.mean - expectedMean) < expectedMean * 0.02);
+        assert(a.percentile5 < a.percentile50 && a.percentile50 < a.percentile95);
+        testFile << "CryptoInvestment simulate mean matches invest PASSED\n";
+
+        // Jumps add excess kurtosis to the log returns; a pure diffusion would have none
+        std::vector<double> terminal(100000);
+        crypto.sampleTerminalValues(amount, 1.0, 3, 0, terminal.data(), terminal.size());
+        double mean = 0.0;
+        for (double& value : terminal) {
+            value = std::log(value / amount);
+            mean += value;
+        }
+        mean /= terminal.size();
+        double second = 0.0, fourth = 0.0;
+        for (double value : terminal) {
+            double d = (value - mean) * (value - mean);
+            second += d;
+            fourth += d * d;
+        }
+        second /= terminal.size();
+        fourth /= terminal.size();
+        assert(fourth / (second * second) - 3.0 > 0.3);
+        testFile << "CryptoInvestment jump-diffusion has fat tails PASSED\n";
+
+        CryptoInvestment calm("Stablecoin", 0.0, 0.5, 0.0, 0.0, 0.0);
+        MonteCarloResult flat = calm.simulate(amount, settings, several);
+        assert(std::abs(flat.percentile5 - calm.invest(amount)) < 1e-9 * amount);
+        assert(flat.standardDeviation < 1e-9 * amount);
+        testFile << "CryptoInvestment simulate without volatility or jumps is deterministic PASSED\n";
+
+        CryptoInvestment jumpy("Jumpy", 0.1, 1.0, 100.0, 0.0, 0.01);
+        std::vector<double> jumpyPaths(512);
+        jumpy.sampleTerminalValues(amount, 3.0, 5, 0, jumpyPaths.data(), jumpyPaths.size());
+        double jumpyMean = 0.0;
+        for (double value : jumpyPaths)
+            jumpyMean += value / jumpyPaths.size();
+        assert(std::abs(jumpyMean - jumpy.invest(amount) * std::exp(jumpy.getDriftRate() * 2.0)) < 0.05 * jumpyMean);
+        for (double horizon : {4.0, 8.0}) {
+            try {
+                jumpy.sampleTerminalValues(amount, horizon, 5, 0, jumpyPaths.data(), jumpyPaths.size());
+                assert(false);
+            } catch (const InvestmentException&) {}
+        }
+        testFile << "CryptoInvestment rejects more expected jumps than it can sample PASSED\n";
+
+        std::vector<double> amounts(37), batch(37);
+        for (size_t i = 0; i < amounts.size(); ++i)
+            amounts[i] = 100.0 + 25.0 * i;
+        crypto.investBatch(amounts.data(), batch.data(), amounts.size());
+        for (size_t i = 0; i < amounts.size(); ++i)
+            assert(batch[i] == crypto.invest(amounts[i]));
+        testFile << "CryptoInvestment investBatch matches invest PASSED\n";
+
+        bool threw = false;
+        try {
+            crypto.setJumpIntensity(-1.0);
+        } catch (const InvestmentException&) {
+            threw = true;
+        }
+        assert(threw && crypto.getJumpIntensity() == 3.0);
+        testFile << "CryptoInvestment rejects negative jump intensity PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Crypto Jump-Diffusion Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
     // Bank Polymorphism Test
     try {
         Bank bank("TestBank", 15000);
@@ -152,6 +1907,83 @@ int main() {
         assert(false);
     }
 
+    // Concurrent Bank Stress Test
+    try {
+        const double initialFunds = 100000.0;
+        const int threadCount = 8;
+        const int operationsPerThread = 20000;
+        Bank bank("SharedBank", initialFunds);
+        bank.setStrategy(std::make_shared<StockInvestment>(0.5, 0.15, 0.2, 0.03));
+
+        std::atomic<bool> overdrawn(false);
+        std::vector<double> netFlow(threadCount, 0.0);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&, t] {
+                double flow = 0.0;
+                for (int i = 0; i < operationsPerThread; ++i) {
+                    double opAmount = static_cast<double>(1 + (i * 7 + t) % 50);
+                    switch ((i + t) % 4) {
+                    case 0:
+                        bank.depositFunds(opAmount);
+                        flow += opAmount;
+                        break;
+                    case 1:
+                        if (bank.withdrawFunds(opAmount * 3))
+                            flow -= opAmount * 3;
+                        break;
+                    case 2:
+                        try {
+                            bank.executeInvestment(opAmount * 5);
+                            flow -= opAmount * 5;
+                        } catch (const InvestmentException&) {
+                        }
+                        break;
+                    default:
+                        if (i % 64 == 3)
+                            bank.setStrategy(std::make_shared<BondInvestment>(0.05, 1 + i % 5, 0.02, false));
+                        break;
+                    }
+                    if (bank.getAvailableFunds() < 0.0)
+                        overdrawn = true;
+                }
+                netFlow[t] = flow;
+            });
+        }
+        for (auto& thread : threads)
+            thread.join();
+
+        double expected = initialFunds;
+        for (double flow : netFlow)
+            expected += flow;
+        assert(!overdrawn);
+        assert(bank.getAvailableFunds() == expected);
+        testFile << "Bank concurrent funds invariant PASSED\n";
+
+        Bank drained("Drained", 1000.0);
+        drained.setStrategy(std::make_shared<BondInvestment>());
+        std::atomic<int> successes(0);
+        std::vector<std::thread> racers;
+        for (int t = 0; t < threadCount; ++t) {
+            racers.emplace_back([&] {
+                for (int i = 0; i < 100; ++i) {
+                    try {
+                        drained.executeInvestment(10.0);
+                        ++successes;
+                    } catch (const InvestmentException&) {
+                    }
+                }
+            });
+        }
+        for (auto& racer : racers)
+            racer.join();
+        assert(successes == 100 && drained.getAvailableFunds() == 0.0);
+        testFile << "Bank concurrent reservations never overdraw PASSED\n";
+    } catch (const std::exception &e) {
+        testFile << "Concurrent Bank Tests FAILED: " << e.what() << "\n";
+        assert(false);
+    }
+
     testFile.close();
     return 0;
 }
@@ -0,0 +1,109 @@
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace {
+thread_local bool insidePoolTask = false;
+}
+
+ThreadPool::ThreadPool(std::size_t threadCount)
+    : task(nullptr), taskCount(0), taskGrain(1), nextIndex(0),
+      activeWorkers(0), generation(0), stopping(false) {
+    if (threadCount == 0)
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    for (std::size_t i = 1; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        stopping = true;
+    }
+    wakeWorkers.notify_all();
+    for (auto& worker : workers)
+        worker.join();
+}
+
+std::size_t ThreadPool::size() const {
+    return workers.size() + 1;
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::parallelFor(std::size_t count, std::size_t grain, const RangeTask& body) {
+    if (count == 0)
+        return;
+    if (grain == 0)
+        grain = 1;
+    if (workers.empty() || count <= grain || insidePoolTask) {
+        body(0, count);
+        return;
+    }
+
+    std::lock_guard<std::mutex> run(runMutex);
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        task = &body;
+        taskCount = count;
+        taskGrain = grain;
+        nextIndex.store(0);
+        activeWorkers = workers.size();
+        firstError = nullptr;
+        ++generation;
+    }
+    wakeWorkers.notify_all();
+
+    insidePoolTask = true;
+    runChunks();
+    insidePoolTask = false;
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        workersDone.wait(lock, [this] { return activeWorkers == 0; });
+        task = nullptr;
+        error = firstError;
+    }
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::runChunks() {
+    for (;;) {
+        std::size_t begin = nextIndex.fetch_add(taskGrain);
+        if (begin >= taskCount)
+            break;
+        std::size_t end = std::min(taskCount, begin + taskGrain);
+        try {
+            (*task)(begin, end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (!firstError)
+                firstError = std::current_exception();
+            nextIndex.store(taskCount);
+        }
+    }
+}
+
+void ThreadPool::workerLoop() {
+    insidePoolTask = true;
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(stateMutex);
+            wakeWorkers.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        runChunks();
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+            if (--activeWorkers == 0)
+                workersDone.notify_one();
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads that execute chunked parallel loops.
+// The calling thread takes part in every loop, so a pool of size 1 has no workers.
+class ThreadPool {
+public:
+    typedef std::function<void(std::size_t begin, std::size_t end)> RangeTask;
+
+    explicit ThreadPool(std::size_t threadCount = 0); // 0 = hardware concurrency
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const;
+
+    // Runs body over [0, count) in chunks of `grain`; blocks until done and rethrows
+    // the first exception thrown by body. Calls from inside a pool task run inline.
+    void parallelFor(std::size_t count, std::size_t grain, const RangeTask& body);
+
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+    void runChunks();
+
+    std::vector<std::thread> workers;
+    std::mutex runMutex;
+    std::mutex stateMutex;
+    std::condition_variable wakeWorkers;
+    std::condition_variable workersDone;
+
+    const RangeTask* task;
+    std::size_t taskCount;
+    std::size_t taskGrain;
+    std::atomic<std::size_t> nextIndex;
+    std::size_t activeWorkers;
+    std::uint64_t generation;
+    bool stopping;
+    std::exception_ptr firstError;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,238 @@
+#include "YieldCurve.h"
+#include "StrategyFormulas.h"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+bool YieldCurve::Adjustments::operator<(const Adjustments& other) const {
+    return std::tie(inflationRate, callableAdjustment, inflationAdjustment, callable) <
+           std::tie(other.inflationRate, other.callableAdjustment, other.inflationAdjustment, other.callable);
+}
+
+bool YieldCurve::Adjustments::operator==(const Adjustments& other) const {
+    return inflationRate == other.inflationRate && callableAdjustment == other.callableAdjustment &&
+           inflationAdjustment == other.inflationAdjustment && callable == other.callable;
+}
+
+YieldCurve::YieldCurve(const std::vector<double>& maturities, const std::vector<double>& zeroRates, int horizonYears)
+    : horizonYears(horizonYears), knotMaturities(maturities), knotRates(zeroRates), version(0) {
+    if (horizonYears <= 0)
+        throw InvestmentException("Curve horizon must be positive");
+    validateKnots(maturities, zeroRates);
+    rebuildGrid();
+}
+
+std::vector<double> YieldCurve::bootstrapZeroRates(const std::vector<int>& maturities,
+                                                   const std::vector<double>& parYields) {
+    if (maturities.empty() || maturities.size() != parYields.size())
+        throw InvestmentException("Curve needs one par yield per maturity");
+    for (std::size_t i = 0; i < maturities.size(); ++i) {
+        if (maturities[i] <= 0 || (i > 0 && maturities[i] <= maturities[i - 1]))
+            throw InvestmentException("Curve maturities must be positive and increasing");
+    }
+
+    // Each year's discount factor prices that year's par bond at 1, given the earlier factors
+    std::vector<double> zeroRates(maturities.size());
+    double annuity = 0.0;
+    std::size_t knot = 0;
+    for (int year = 1; year <= maturities.back(); ++year) {
+        while (maturities[knot] < year)
+            ++knot;
+        double parYield = parYields[knot];
+        if (knot > 0 && year < maturities[knot]) {
+            const double weight = static_cast<double>(year - maturities[knot - 1]) / (maturities[knot] - maturities[knot - 1]);
+            parYield = parYields[knot - 1] + weight * (parYields[knot] - parYields[knot - 1]);
+        }
+        const double discount = (1.0 - parYield * annuity) / (1.0 + parYield);
+        if (!(discount > 0.0))
+            throw InvestmentException("Par yields do not give positive discount factors");
+        annuity += discount;
+        if (year == maturities[knot])
+            zeroRates[knot] = std::pow(discount, -1.0 / year) - 1.0;
+    }
+    return zeroRates;
+}
+
+void YieldCurve::validateKnots(const std::vector<double>& maturities, const std::vector<double>& zeroRates) {
+    if (maturities.empty() || maturities.size() != zeroRates.size())
+        throw InvestmentException("Curve needs one zero rate per maturity");
+    for (std::size_t i = 0; i < maturities.size(); ++i) {
+        if (!(maturities[i] > 0.0) || (i > 0 && !(maturities[i] > maturities[i - 1])))
+            throw InvestmentException("Curve maturities must be positive and increasing");
+        if (!(zeroRates[i] >= 0.0))
+            throw InvestmentException("Zero rates cannot be negative");
+    }
+}
+
+void YieldCurve::setZeroRates(const std::vector<double>& maturities, const std::vector<double>& zeroRates) {
+    validateKnots(maturities, zeroRates);
+    std::lock_guard<std::mutex> lock(mutex);
+    knotMaturities = maturities;
+    knotRates = zeroRates;
+    rebuildGrid();
+    for (std::map<Adjustments, AdjustedGrid>::iterator grid = adjustedGrids.begin(); grid != adjustedGrids.end(); ++grid)
+        fillAdjustedGrid(grid->first, grid->second);
+    for (std::unordered_map<BondInvestment*, Dependent>::iterator dependent = dependents.begin();
+         dependent != dependents.end(); ++dependent)
+        priceLocked(*dependent->first, dependent->second, false);
+}
+
+double YieldCurve::interpolate(double years) const {
+    if (years <= knotMaturities.front())
+        return knotRates.front();
+    if (years >= knotMaturities.back())
+        return knotRates.back();
+    const std::size_t upper = std::upper_bound(knotMaturities.begin(), knotMaturities.end(), years) - knotMaturities.begin();
+    const double weight = (years - knotMaturities[upper - 1]) / (knotMaturities[upper] - knotMaturities[upper - 1]);
+    return knotRates[upper - 1] + weight * (knotRates[upper] - knotRates[upper - 1]);
+}
+
+// Growth factors use the bond formula, so a bond on the curve prices exactly like a flat bond at
+// the curve's rate for its term
+void YieldCurve::rebuildGrid() {
+    gridRates.resize(horizonYears + 1);
+    gridGrowth.resize(horizonYears + 1);
+    gridDiscount.resize(horizonYears + 1);
+    for (int years = 0; years <= horizonYears; ++years) {
+        gridRates[years] = interpolate(years);
+        gridGrowth[years] = bondGrowthFactor(gridRates[years], static_cast<double>(years));
+        gridDiscount[years] = 1.0 / gridGrowth[years];
+    }
+    ++version;
+}
+
+YieldCurve::Adjustments YieldCurve::adjustmentsOf(const BondInvestment& bond) {
+    Adjustments adjustments;
+    adjustments.inflationRate = bond.inflationRate;
+    adjustments.callableAdjustment = bond.callableAdjustment;
+    adjustments.inflationAdjustment = bond.inflationAdjustment;
+    adjustments.callable = bond.callable;
+    return adjustments;
+}
+
+void YieldCurve::fillAdjustedGrid(const Adjustments& adjustments, AdjustedGrid& grid) const {
+    grid.effectiveRate.resize(horizonYears + 1);
+    grid.growthFactor.resize(horizonYears + 1);
+    for (int years = 0; years <= horizonYears; ++years) {
+        const double rate = bondEffectiveRate(gridRates[years], adjustments.inflationRate, adjustments.callable,
+                                              adjustments.callableAdjustment, adjustments.inflationAdjustment);
+        grid.effectiveRate[years] = rate;
+        grid.growthFactor[years] = bondGrowthFactor(rate, static_cast<double>(years));
+    }
+}
+
+// Grids are counted per attached bond, so setter churn cannot grow the map past one grid per
+// bond and a grid goes as soon as its last bond moves away or detaches
+YieldCurve::AdjustedGrid& YieldCurve::acquireGrid(const Adjustments& adjustments) {
+    std::map<Adjustments, AdjustedGrid>::iterator found = adjustedGrids.find(adjustments);
+    if (found == adjustedGrids.end()) {
+        found = adjustedGrids.insert(std::make_pair(adjustments, AdjustedGrid())).first;
+        fillAdjustedGrid(adjustments, found->second);
+        found->second.users = 0;
+    }
+    ++found->second.users;
+    return found->second;
+}
+
+void YieldCurve::releaseGrid(const Adjustments& adjustments) {
+    std::map<Adjustments, AdjustedGrid>::iterator found = adjustedGrids.find(adjustments);
+    if (found != adjustedGrids.end() && --found->second.users == 0)
+        adjustedGrids.erase(found);
+}
+
+void YieldCurve::priceLocked(BondInvestment& bond, Dependent& dependent, bool termsChanged) {
+    const Adjustments adjustments = adjustmentsOf(bond);
+    if (!(adjustments == dependent.adjustments)) {
+        // Taken before the old grid is released, so a grid the bond returns to is not rebuilt
+        dependent.grid = &acquireGrid(adjustments);
+        releaseGrid(dependent.adjustments);
+        dependent.adjustments = adjustments;
+    }
+    const AdjustedGrid* grid = dependent.grid;
+    bond.interestRate = gridRates[bond.termYears];
+    bond.cachedEffectiveRate = grid->effectiveRate[bond.termYears];
+    bond.cachedGrowthFactor = grid->growthFactor[bond.termYears];
+    if (termsChanged)
+        bond.updateFingerprint();
+    else
+        bond.parameterFingerprint = BondInvestment::mixFingerprint(bond.termsFingerprint, bond.interestRate);
+}
+
+// A copied bond attaches already priced, so its current adjustments are the ones it uses
+void YieldCurve::attach(BondInvestment& bond) {
+    std::lock_guard<std::mutex> lock(mutex);
+    Dependent dependent;
+    dependent.adjustments = adjustmentsOf(bond);
+    dependent.grid = nullptr;
+    std::pair<std::unordered_map<BondInvestment*, Dependent>::iterator, bool> inserted =
+        dependents.insert(std::make_pair(&bond, dependent));
+    if (inserted.second)
+        inserted.first->second.grid = &acquireGrid(dependent.adjustments);
+}
+
+void YieldCurve::detach(BondInvestment& bond) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<BondInvestment*, Dependent>::iterator found = dependents.find(&bond);
+    if (found == dependents.end())
+        return;
+    releaseGrid(found->second.adjustments);
+    dependents.erase(found);
+}
+
+void YieldCurve::price(BondInvestment& bond) {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::unordered_map<BondInvestment*, Dependent>::iterator found = dependents.find(&bond);
+    if (found == dependents.end())
+        throw InvestmentException("Bond is not attached to this curve");
+    priceLocked(bond, found->second, true);
+}
+
+double YieldCurve::zeroRate(double years) const {
+    if (!(years >= 0.0))
+        throw InvestmentException("Curve maturity cannot be negative");
+    return interpolate(years);
+}
+
+double YieldCurve::gridZeroRate(int years) const {
+    if (years < 0 || years > horizonYears)
+        throw InvestmentException("Years are outside the curve horizon");
+    return gridRates[years];
+}
+
+double YieldCurve::growthFactor(int years) const {
+    if (years < 0 || years > horizonYears)
+        throw InvestmentException("Years are outside the curve horizon");
+    return gridGrowth[years];
+}
+
+double YieldCurve::discountFactor(int years) const {
+    if (years < 0 || years > horizonYears)
+        throw InvestmentException("Years are outside the curve horizon");
+    return gridDiscount[years];
+}
+
+int YieldCurve::getHorizonYears() const {
+    return horizonYears;
+}
+
+const std::vector<double>& YieldCurve::getMaturities() const {
+    return knotMaturities;
+}
+
+const std::vector<double>& YieldCurve::getZeroRates() const {
+    return knotRates;
+}
+
+std::uint64_t YieldCurve::getVersion() const {
+    return version;
+}
+
+std::size_t YieldCurve::dependentCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return dependents.size();
+}
+
+std::size_t YieldCurve::adjustedGridCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return adjustedGrids.size();
+}
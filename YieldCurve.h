@@ -0,0 +1,107 @@
+#ifndef YIELD_CURVE_H
+#define YIELD_CURVE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "InvestmentSimulator.h"
+
+// Zero-coupon yield curve that bonds are priced off instead of a flat interest rate. Zero rates
+// (annual compounding) are given at knot maturities in years, interpolated linearly between knots
+// and held flat beyond the first and last. Every update fills a dense grid of zero rates, growth
+// factors (1 + z)^years and discount factors for each whole year up to the horizon.
+//
+// Bonds attach with BondInvestment::setYieldCurve and share the curve without copying it. The
+// curve keeps one grid of effective rates and growth factors per distinct set of adjustments
+// (inflation, callable) among its attached bonds, rebuilt once per update, so repricing an
+// attached bond is a lookup. A grid is dropped once no attached bond uses its adjustments. An
+// update refreshes only the bonds attached to this curve; their fingerprints change, so
+// StrategyCache misses for them and keeps its other entries. Like the bond setters, an update
+// must not run while its bonds are being priced.
+class YieldCurve {
+public:
+    YieldCurve(const std::vector<double>& maturities, const std::vector<double>& zeroRates, int horizonYears = 50);
+
+    YieldCurve(const YieldCurve&) = delete;
+    YieldCurve& operator=(const YieldCurve&) = delete;
+
+    // Zero rates at the given maturities implied by par yields of bonds paying annual coupons.
+    // Par yields for the years between maturities are interpolated linearly.
+    static std::vector<double> bootstrapZeroRates(const std::vector<int>& maturities,
+                                                  const std::vector<double>& parYields);
+
+    // Replaces the knots, rebuilds the grids and reprices every attached bond
+    void setZeroRates(const std::vector<double>& maturities, const std::vector<double>& zeroRates);
+
+    double zeroRate(double years) const;
+    // Grid lookups for whole years in [0, horizon]
+    double gridZeroRate(int years) const;
+    double growthFactor(int years) const;
+    double discountFactor(int years) const;
+
+    int getHorizonYears() const;
+    const std::vector<double>& getMaturities() const;
+    const std::vector<double>& getZeroRates() const;
+    // Incremented by every update
+    std::uint64_t getVersion() const;
+    std::size_t dependentCount() const;
+    std::size_t adjustedGridCount() const;
+
+private:
+    friend class BondInvestment;
+
+    // The bond fields bondEffectiveRate reads besides the rate itself
+    struct Adjustments {
+        double inflationRate;
+        double callableAdjustment;
+        double inflationAdjustment;
+        bool callable;
+
+        bool operator<(const Adjustments& other) const;
+        bool operator==(const Adjustments& other) const;
+    };
+
+    struct AdjustedGrid {
+        std::vector<double> effectiveRate;
+        std::vector<double> growthFactor;
+        std::size_t users;                  // attached bonds priced with these adjustments
+    };
+
+    // What an attached bond was last priced with
+    struct Dependent {
+        Adjustments adjustments;
+        AdjustedGrid* grid;
+    };
+
+    static void validateKnots(const std::vector<double>& maturities, const std::vector<double>& zeroRates);
+    static Adjustments adjustmentsOf(const BondInvestment& bond);
+    double interpolate(double years) const;
+    void rebuildGrid();
+    void fillAdjustedGrid(const Adjustments& adjustments, AdjustedGrid& grid) const;
+    AdjustedGrid& acquireGrid(const Adjustments& adjustments);
+    void releaseGrid(const Adjustments& adjustments);
+    // Only the rate changes on a curve update, which lets the fingerprint refresh cheaply
+    void priceLocked(BondInvestment& bond, Dependent& dependent, bool termsChanged);
+
+    // Called by BondInvestment
+    void attach(BondInvestment& bond);
+    void detach(BondInvestment& bond);
+    void price(BondInvestment& bond);
+
+    int horizonYears;
+    std::vector<double> knotMaturities;
+    std::vector<double> knotRates;
+    std::vector<double> gridRates;          // index = years
+    std::vector<double> gridGrowth;
+    std::vector<double> gridDiscount;
+    std::uint64_t version;
+
+    mutable std::mutex mutex;               // guards the dependents and the adjusted grids
+    std::unordered_map<BondInvestment*, Dependent> dependents;
+    std::map<Adjustments, AdjustedGrid> adjustedGrids;
+};
+
+#endif // YIELD_CURVE_H